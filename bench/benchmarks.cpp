@@ -0,0 +1,761 @@
+#include "acid_list.hpp"
+#include "concurrent_lru.hpp"
+#include "priority_list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+using Benchmark = std::function<void()>;
+
+template <class Fn>
+double MeasureSeconds(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(finish - start).count();
+}
+
+void ReportOpsPerSecond(const std::string& name, size_t ops, double seconds) {
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << static_cast<double>(ops) / seconds / 1e6 << " Mops/s" << std::endl;
+}
+
+template <class List>
+double MeasurePushBack(size_t n) {
+    auto list = std::make_unique<List>();
+    return MeasureSeconds([&list, n] {
+        for (size_t i = 0; i < n; i++) {
+            list->push_back(i);
+        }
+    });
+}
+
+void BenchPushBack() {
+    const size_t n = 2000000;
+    // Warm up the allocator so that neither container pays for fresh pages.
+    MeasurePushBack<polyndrom::acid_list<int64_t>>(n);
+    double std_list_seconds = MeasurePushBack<std::list<int64_t>>(n);
+    double acid_list_seconds = MeasurePushBack<polyndrom::acid_list<int64_t>>(n);
+    double single_thread_seconds =
+        MeasurePushBack<polyndrom::acid_list<int64_t, polyndrom::single_thread_policy>>(n);
+    ReportOpsPerSecond("push_back/std::list", n, std_list_seconds);
+    ReportOpsPerSecond("push_back/acid_list", n, acid_list_seconds);
+    ReportOpsPerSecond("push_back/acid_list<single_thread_policy>", n, single_thread_seconds);
+    std::cout << "push_back/acid_list to std::list time ratio: "
+              << acid_list_seconds / std_list_seconds << std::endl;
+    std::cout << "push_back/acid_list<single_thread_policy> to std::list time ratio: "
+              << single_thread_seconds / std_list_seconds << std::endl;
+}
+
+void BenchScan() {
+    const size_t n = 2000000;
+    polyndrom::acid_list<int64_t> list;
+    for (size_t i = 0; i < n; i++) {
+        list.push_back(i);
+    }
+    int64_t owned_sum = 0;
+    double owned_seconds = MeasureSeconds([&list, &owned_sum] {
+        owned_sum = std::accumulate(list.begin(), list.end(), int64_t{0});
+    });
+    int64_t borrowed_sum = 0;
+    double borrowed_seconds = MeasureSeconds([&list, &borrowed_sum] {
+        auto scope = list.borrow();
+        borrowed_sum = std::accumulate(scope.begin(), scope.end(), int64_t{0});
+    });
+    int64_t traversed_sum = 0;
+    double traverse_seconds = MeasureSeconds([&list, &traversed_sum] {
+        list.traverse([&traversed_sum](int64_t value) {
+            traversed_sum += value;
+        });
+    });
+    int64_t reverse_sum = 0;
+    double reverse_seconds = MeasureSeconds([&list, &reverse_sum] {
+        for (auto it = list.end(); it != list.begin();) {
+            reverse_sum += *--it;
+        }
+    });
+    ReportOpsPerSecond("scan/list_iterator", n, owned_seconds);
+    ReportOpsPerSecond("scan/borrowed_iterator", n, borrowed_seconds);
+    ReportOpsPerSecond("scan/traverse", n, traverse_seconds);
+    ReportOpsPerSecond("scan/list_iterator_reverse", n, reverse_seconds);
+    bool mismatch = owned_sum != borrowed_sum || owned_sum != traversed_sum || owned_sum != reverse_sum;
+    for (size_t batch_size : {16, 256}) {
+        int64_t batched_sum = 0;
+        double batched_seconds = MeasureSeconds([&list, &batched_sum, batch_size] {
+            list.for_each_batch(list.begin(), list.end(), batch_size, [&batched_sum](std::span<const int64_t> batch) {
+                batched_sum = std::accumulate(batch.begin(), batch.end(), batched_sum);
+            });
+        });
+        int64_t reverse_batched_sum = 0;
+        double reverse_batched_seconds = MeasureSeconds([&list, &reverse_batched_sum, batch_size] {
+            list.reverse_for_each_batch(list.begin(), list.end(), batch_size, [&reverse_batched_sum](std::span<const int64_t> batch) {
+                reverse_batched_sum = std::accumulate(batch.begin(), batch.end(), reverse_batched_sum);
+            });
+        });
+        ReportOpsPerSecond("scan/for_each_batch_" + std::to_string(batch_size), n, batched_seconds);
+        ReportOpsPerSecond("scan/reverse_for_each_batch_" + std::to_string(batch_size), n, reverse_batched_seconds);
+        mismatch |= owned_sum != batched_sum || owned_sum != reverse_batched_sum;
+    }
+    if (mismatch) {
+        std::cerr << "scan: checksum mismatch" << std::endl;
+    }
+}
+
+void RunOnNumaNode(int node) {
+#ifdef ACID_LIST_HAS_LIBNUMA
+    if (polyndrom::numa_nodes_count() > 1) {
+        numa_run_on_node(node);
+    }
+#endif
+}
+
+void BenchNumaPlacement() {
+    const size_t n = 1000000;
+    const size_t scans_count = 5;
+    const int nodes_count = polyndrom::numa_nodes_count();
+    const std::vector<std::pair<std::string, polyndrom::numa_policy>> policies = {
+        {"system_default", polyndrom::numa_policy{}},
+        {"local", polyndrom::numa_policy::local()},
+        {"bind(0)", polyndrom::numa_policy::bind(0)},
+        {"interleave", polyndrom::numa_policy::interleave()},
+    };
+    for (const auto& [policy_name, policy] : policies) {
+        std::vector<double> insert_seconds(nodes_count);
+        std::vector<double> scan_seconds(nodes_count);
+        std::vector<std::thread> threads;
+        for (int node = 0; node < nodes_count; node++) {
+            threads.emplace_back([&, policy = policy, node] {
+                RunOnNumaNode(node);
+                polyndrom::acid_list<int64_t> list(policy);
+                insert_seconds[node] = MeasureSeconds([&list, n] {
+                    for (size_t i = 0; i < n; i++) {
+                        list.push_back(i);
+                    }
+                });
+                scan_seconds[node] = MeasureSeconds([&list, scans_count] {
+                    for (size_t i = 0; i < scans_count; i++) {
+                        auto scope = list.borrow();
+                        volatile int64_t sum = std::accumulate(scope.begin(), scope.end(), int64_t{0});
+                        (void) sum;
+                    }
+                });
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int node = 0; node < nodes_count; node++) {
+            std::string prefix = "numa/" + policy_name + "/socket" + std::to_string(node);
+            ReportOpsPerSecond(prefix + "/push_back", n, insert_seconds[node]);
+            ReportOpsPerSecond(prefix + "/scan", n * scans_count, scan_seconds[node]);
+        }
+    }
+}
+
+void BenchColdStart() {
+    const size_t n = 10000000;
+    std::string path = "/tmp/acid_list_bench_snapshot.bin";
+    double replay_seconds = 0;
+    {
+        polyndrom::acid_list<int64_t> list;
+        replay_seconds = MeasureSeconds([&list, n] {
+            for (size_t i = 0; i < n; i++) {
+                list.push_back(i);
+            }
+        });
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        double serialize_seconds = MeasureSeconds([&list, fd] {
+            list.serialize(fd);
+        });
+        ::close(fd);
+        ReportOpsPerSecond("cold_start/serialize", n, serialize_seconds);
+    }
+    polyndrom::acid_list<int64_t> loaded;
+    double load_seconds = MeasureSeconds([&loaded, &path] {
+        loaded.load(path);
+    });
+    ::unlink(path.c_str());
+    ReportOpsPerSecond("cold_start/push_back_replay", n, replay_seconds);
+    ReportOpsPerSecond("cold_start/load", n, load_seconds);
+    std::cout << "cold_start: replay " << replay_seconds << " s, load " << load_seconds << " s" << std::endl;
+}
+
+// Sliding window: every tick drops the oldest window elements and appends as many new ones.
+void BenchSlidingWindow() {
+    const int64_t window = 64;
+    const int64_t ticks = 50000;
+    std::vector<int64_t> values(window);
+    std::iota(values.begin(), values.end(), 0);
+
+    polyndrom::acid_list<int64_t> per_element;
+    per_element.insert(per_element.end(), values.begin(), values.end());
+    double per_element_seconds = MeasureSeconds([&] {
+        for (int64_t tick = 0; tick < ticks; tick++) {
+            for (int64_t i = 0; i < window; i++) {
+                per_element.erase(per_element.begin());
+                per_element.push_back(i);
+            }
+        }
+    });
+
+    polyndrom::acid_list<int64_t> ranged;
+    ranged.insert(ranged.end(), values.begin(), values.end());
+    double ranged_seconds = MeasureSeconds([&] {
+        for (int64_t tick = 0; tick < ticks; tick++) {
+            ranged.replace_range(ranged.begin(), ranged.end(), values.begin(), values.end());
+        }
+    });
+    ReportOpsPerSecond("sliding_window/per_element", ticks * window, per_element_seconds);
+    ReportOpsPerSecond("sliding_window/replace_range", ticks * window, ranged_seconds);
+}
+
+// Counts matching keys of records with a large payload: inline in the nodes versus in a
+// structure-of-arrays arena where only the key column is read.
+void BenchSoaScan() {
+    struct Record {
+        int64_t key;
+        double payload[7];
+    };
+    const int64_t n = 2000000;
+    polyndrom::acid_list<Record> inline_list;
+    polyndrom::soa_arena<int64_t, std::array<double, 7>> arena;
+    polyndrom::soa_list<int64_t, std::array<double, 7>> soa_list;
+    for (int64_t i = 0; i < n; i++) {
+        inline_list.push_back(Record{i, {}});
+        soa_list.push_back(arena.make(i, {}));
+    }
+    size_t inline_count = 0;
+    double inline_seconds = MeasureSeconds([&] {
+        inline_list.traverse([&inline_count](const Record& record) {
+            inline_count += record.key % 3 == 0;
+        });
+    });
+    size_t soa_count = 0;
+    double soa_seconds = MeasureSeconds([&] {
+        soa_count = arena.count_if<0>([](int64_t key) {
+            return key % 3 == 0;
+        });
+    });
+    ReportOpsPerSecond("soa_scan/inline_traverse", n, inline_seconds);
+    ReportOpsPerSecond("soa_scan/arena_count_if", n, soa_seconds);
+    if (inline_count != soa_count) {
+        std::cerr << "soa_scan: count mismatch" << std::endl;
+    }
+}
+
+void BenchAggregates() {
+    const int64_t n = 2000000;
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < n; i++) {
+        list.push_back(i % 1000);
+    }
+    size_t iterator_count = 0;
+    double iterator_seconds = MeasureSeconds([&] {
+        iterator_count = std::count(list.begin(), list.end(), 42);
+    });
+    size_t member_count = 0;
+    double member_seconds = MeasureSeconds([&] {
+        member_count = list.count(42);
+    });
+    int64_t sum = 0;
+    double sum_seconds = MeasureSeconds([&] {
+        sum = list.sum();
+    });
+    ReportOpsPerSecond("aggregates/std_count", n, iterator_seconds);
+    ReportOpsPerSecond("aggregates/count", n, member_seconds);
+    ReportOpsPerSecond("aggregates/sum", n, sum_seconds);
+    if (iterator_count != member_count || sum != n / 1000 * 499500) {
+        std::cerr << "aggregates: result mismatch" << std::endl;
+    }
+}
+
+// The usual hand-built cache: one mutex around a list and a map of its iterators.
+class LockedLru {
+public:
+    explicit LockedLru(size_t capacity) : capacity_(capacity) {
+    }
+
+    std::optional<int64_t> get(int64_t key) {
+        std::lock_guard lock(mutex_);
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            return std::nullopt;
+        }
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->second;
+    }
+
+    void put(int64_t key, int64_t value) {
+        std::lock_guard lock(mutex_);
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            found->second->second = value;
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return;
+        }
+        entries_.emplace_front(key, value);
+        index_.emplace(key, entries_.begin());
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::list<std::pair<int64_t, int64_t>> entries_;
+    std::unordered_map<int64_t, std::list<std::pair<int64_t, int64_t>>::iterator> index_;
+};
+
+// Read-mostly cache workload with skewed keys: a miss is followed by a put, like a cache in
+// front of a slower store.
+template <class Cache>
+void MeasureLru(const std::string& name, size_t threads_count) {
+    const size_t capacity = 10000;
+    const size_t ops_per_thread = 400000;
+    Cache cache(capacity);
+    std::atomic<size_t> hits = 0;
+    double seconds = MeasureSeconds([&] {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threads_count; i++) {
+            threads.emplace_back([&cache, &hits, i, ops_per_thread, capacity] {
+                std::mt19937_64 engine(i);
+                std::uniform_real_distribution<double> uniform(0, 1);
+                size_t thread_hits = 0;
+                for (size_t j = 0; j < ops_per_thread; j++) {
+                    double u = uniform(engine);
+                    auto key = static_cast<int64_t>(u * u * u * capacity * 4);
+                    if (cache.get(key)) {
+                        thread_hits++;
+                    } else {
+                        cache.put(key, key);
+                    }
+                }
+                hits += thread_hits;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    size_t ops = threads_count * ops_per_thread;
+    ReportOpsPerSecond(name + "/" + std::to_string(threads_count) + "_threads", ops, seconds);
+    std::cout << name << "/" << threads_count << "_threads hit ratio: "
+              << static_cast<double>(hits) / static_cast<double>(ops) << std::endl;
+}
+
+void BenchLru() {
+    for (size_t threads_count : {1, 4}) {
+        MeasureLru<LockedLru>("lru/locked_std_list", threads_count);
+        MeasureLru<polyndrom::concurrent_lru<int64_t, int64_t>>("lru/concurrent_lru", threads_count);
+    }
+}
+
+// Per-element work heavy enough for a traversal to be worth splitting.
+int64_t Churn(int64_t value) {
+    uint64_t state = static_cast<uint64_t>(value);
+    for (int i = 0; i < 32; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return static_cast<int64_t>(state >> 33);
+}
+
+// Processing one list with several threads: split by a prebuilt vector of iterators versus
+// the work-stealing partition, which needs no pass over the list up front.
+void BenchPartition() {
+    const int64_t n = 1000000;
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < n; i++) {
+        list.push_back(i);
+    }
+    std::atomic<int64_t> checksum = 0;
+    double traverse_seconds = MeasureSeconds([&] {
+        int64_t sum = 0;
+        list.traverse([&sum](int64_t value) {
+            sum += Churn(value);
+        });
+        checksum = sum;
+    });
+    ReportOpsPerSecond("partition/traverse", n, traverse_seconds);
+    const int64_t expected = checksum;
+
+    for (size_t workers_count : {1, 2, 4}) {
+        checksum = 0;
+        std::vector<size_t> visited(workers_count);
+        double seconds = MeasureSeconds([&] {
+            auto work = list.partition(workers_count);
+            std::vector<std::thread> workers;
+            for (size_t worker = 0; worker < workers_count; worker++) {
+                workers.emplace_back([&, worker] {
+                    int64_t sum = 0;
+                    work.run(worker, [&](int64_t value) {
+                        sum += Churn(value);
+                        visited[worker]++;
+                    });
+                    checksum += sum;
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+        std::string name = "partition/work_stealing_" + std::to_string(workers_count);
+        ReportOpsPerSecond(name, n, seconds);
+        std::cout << name << " elements per worker:";
+        for (size_t count : visited) {
+            std::cout << " " << count;
+        }
+        std::cout << std::endl;
+        if (checksum != expected) {
+            std::cerr << name << ": checksum mismatch" << std::endl;
+        }
+    }
+
+    const size_t workers_count = 4;
+    checksum = 0;
+    double vector_seconds = MeasureSeconds([&] {
+        std::vector<polyndrom::acid_list<int64_t>::iterator> positions;
+        positions.reserve(n);
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            positions.push_back(it);
+        }
+        std::vector<std::thread> workers;
+        for (size_t worker = 0; worker < workers_count; worker++) {
+            workers.emplace_back([&, worker] {
+                int64_t sum = 0;
+                size_t from = positions.size() * worker / workers_count;
+                size_t to = positions.size() * (worker + 1) / workers_count;
+                for (size_t i = from; i < to; i++) {
+                    sum += Churn(*positions[i]);
+                }
+                checksum += sum;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+    ReportOpsPerSecond("partition/iterator_vector_4", n, vector_seconds);
+    if (checksum != expected) {
+        std::cerr << "partition/iterator_vector_4: checksum mismatch" << std::endl;
+    }
+}
+
+// Request-scoped lists: each round fills a fresh list and drops it.
+void BenchArena() {
+    const size_t n = 100000;
+    const size_t rounds = 20;
+    double heap_seconds = MeasureSeconds([&] {
+        for (size_t round = 0; round < rounds; round++) {
+            polyndrom::acid_list<int64_t> list;
+            for (size_t i = 0; i < n; i++) {
+                list.push_back(i);
+            }
+        }
+    });
+    std::pmr::monotonic_buffer_resource arena;
+    double arena_seconds = MeasureSeconds([&] {
+        for (size_t round = 0; round < rounds; round++) {
+            {
+                polyndrom::pmr::acid_list<int64_t> list(&arena);
+                for (size_t i = 0; i < n; i++) {
+                    list.push_back(i);
+                }
+            }
+            arena.release();
+        }
+    });
+    double discard_seconds = MeasureSeconds([&] {
+        for (size_t round = 0; round < rounds; round++) {
+            {
+                polyndrom::pmr::acid_list<int64_t> list(&arena);
+                for (size_t i = 0; i < n; i++) {
+                    list.push_back(i);
+                }
+                list.discard();
+            }
+            arena.release();
+        }
+    });
+    ReportOpsPerSecond("arena/new_delete", n * rounds, heap_seconds);
+    ReportOpsPerSecond("arena/monotonic_buffer", n * rounds, arena_seconds);
+    ReportOpsPerSecond("arena/monotonic_buffer_discard", n * rounds, discard_seconds);
+}
+
+// A batch of changes near the front of a large list that is then undone, either by
+// restoring a copy taken before the batch or by rolling back to a checkpoint. Reported per
+// element of the list, as that is what a copy costs.
+void BenchHistory() {
+    const size_t n = 100000;
+    const size_t rounds = 50;
+    const size_t batch_size = 100;
+    auto run_batch = [batch_size](polyndrom::acid_list<int64_t>& list) {
+        for (size_t i = 0; i < batch_size; i++) {
+            list.erase(list.begin());
+            list.push_front(-static_cast<int64_t>(i));
+        }
+    };
+    polyndrom::acid_list<int64_t> copied;
+    for (size_t i = 0; i < n; i++) {
+        copied.push_back(i);
+    }
+    double copy_seconds = MeasureSeconds([&] {
+        for (size_t round = 0; round < rounds; round++) {
+            std::vector<int64_t> saved = copied.snapshot();
+            run_batch(copied);
+            copied.replace_range(copied.begin(), copied.end(), saved.begin(), saved.end());
+        }
+    });
+    polyndrom::acid_list<int64_t> tracked;
+    for (size_t i = 0; i < n; i++) {
+        tracked.push_back(i);
+    }
+    tracked.track_history(true);
+    double rollback_seconds = MeasureSeconds([&] {
+        for (size_t round = 0; round < rounds; round++) {
+            auto checkpoint = tracked.checkpoint();
+            run_batch(tracked);
+            tracked.rollback_to(checkpoint);
+        }
+    });
+    ReportOpsPerSecond("history/copy_and_restore", rounds * n, copy_seconds);
+    ReportOpsPerSecond("history/checkpoint_rollback", rounds * n, rollback_seconds);
+}
+
+// Sessions cache positions in a sliding window and refresh them rarely. Cached
+// list_iterators keep the erased nodes after their position alive, weak_iterators don't.
+template<class Position>
+void MeasureCachedPositions(const std::string& name) {
+    using list_type = polyndrom::type_stable_list<int64_t>;
+    const size_t window = 1000;
+    const size_t ops = 2000000;
+    const size_t sessions_count = 16;
+    const size_t refresh_interval = 200000;
+    list_type list;
+    for (size_t i = 0; i < window; i++) {
+        list.push_back(i);
+    }
+    std::vector<Position> sessions(sessions_count);
+    size_t peak_unreclaimed = 0;
+    double seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < ops; i++) {
+            list.push_back(i);
+            list.try_pop_front();
+            if (i % (refresh_interval / sessions_count) == 0) {
+                sessions[i / (refresh_interval / sessions_count) % sessions_count] = Position(std::prev(list.end()));
+                peak_unreclaimed = std::max(peak_unreclaimed, list_type::unreclaimed_of_type().nodes);
+            }
+        }
+    });
+    ReportOpsPerSecond(name, 2 * ops, seconds);
+    std::cout << name << " peak unreclaimed nodes: " << peak_unreclaimed << std::endl;
+}
+
+// Node allocation and release only, every thread churning a list of its own.
+template<class List>
+void MeasureNodeChurn(const std::string& name, size_t threads_count) {
+    const size_t total_rounds = 4000000;
+    double seconds = MeasureSeconds([&] {
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < threads_count; thread++) {
+            threads.emplace_back([rounds = total_rounds / threads_count] {
+                List list;
+                for (size_t i = 0; i < rounds; i++) {
+                    list.push_back(static_cast<int64_t>(i));
+                    list.try_pop_front();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    ReportOpsPerSecond(name + "_" + std::to_string(threads_count) + "_threads", 2 * total_rounds, seconds);
+}
+
+void BenchWeakIterators() {
+    for (size_t threads_count : {1, 4}) {
+        MeasureNodeChurn<polyndrom::acid_list<int64_t>>("weak/churn_std_allocator", threads_count);
+        MeasureNodeChurn<polyndrom::type_stable_list<int64_t>>("weak/churn_type_stable_allocator", threads_count);
+    }
+
+    MeasureCachedPositions<polyndrom::type_stable_list<int64_t>::iterator>("weak/cached_list_iterator");
+    MeasureCachedPositions<polyndrom::type_stable_list<int64_t>::weak_iterator>("weak/cached_weak_iterator");
+
+    polyndrom::type_stable_list<int64_t> list;
+    list.push_back(1);
+    polyndrom::type_stable_list<int64_t>::weak_iterator weak(list.begin());
+    const size_t locks = 10000000;
+    int64_t sum = 0;
+    double seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < locks; i++) {
+            sum += **weak.lock();
+        }
+    });
+    ReportOpsPerSecond("weak/lock", locks, seconds);
+    if (sum != static_cast<int64_t>(locks)) {
+        std::cout << "weak/lock: unexpected sum" << std::endl;
+    }
+}
+
+// Every thread inserts at the front and erases what it inserted, so all writers fight over
+// the first nodes and most attempts fail validation.
+void BenchContention() {
+    const size_t total_rounds = 400000;
+    const std::pair<const char*, polyndrom::contention_policy> strategies[] = {
+        {"none", polyndrom::contention_policy::none()},
+        {"exponential", polyndrom::contention_policy::exponential()},
+        {"escalating", polyndrom::contention_policy::escalating()},
+    };
+    for (size_t threads_count : {4, 16, 64}) {
+        for (const auto& [strategy, contention] : strategies) {
+            polyndrom::acid_list<int64_t> list(contention);
+            list.push_back(0);
+            double seconds = MeasureSeconds([&] {
+                std::vector<std::thread> threads;
+                for (size_t thread = 0; thread < threads_count; thread++) {
+                    threads.emplace_back([&list, rounds = total_rounds / threads_count] {
+                        for (size_t i = 0; i < rounds; i++) {
+                            list.erase(list.insert(list.begin(), static_cast<int64_t>(i)));
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            });
+            std::string name = "contention/" + std::string(strategy) + "_" + std::to_string(threads_count);
+            ReportOpsPerSecond(name, 2 * total_rounds, seconds);
+        }
+    }
+}
+
+// Scheduler-like use: every thread inserts a task a random distance ahead of the current
+// time and then takes the earliest one, with the queue holding about queue_size tasks.
+template<class Queue>
+void MeasureScheduler(const std::string& name, size_t threads_count, Queue& queue) {
+    const size_t total_rounds = 400000;
+    const size_t queue_size = 1024;
+    std::atomic<int64_t> now = 0;
+    for (size_t i = 0; i < queue_size; i++) {
+        queue.insert(static_cast<int64_t>(i), static_cast<int64_t>(i));
+    }
+    double seconds = MeasureSeconds([&] {
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < threads_count; thread++) {
+            threads.emplace_back([&queue, &now, thread, rounds = total_rounds / threads_count] {
+                std::mt19937 engine(static_cast<uint32_t>(thread));
+                for (size_t i = 0; i < rounds; i++) {
+                    int64_t due = now.load(std::memory_order_relaxed) + static_cast<int64_t>(engine() % queue_size);
+                    queue.insert(due, static_cast<int64_t>(i));
+                    if (auto task = queue.delete_min()) {
+                        now.store(task->priority, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    ReportOpsPerSecond(name + "_" + std::to_string(threads_count), 2 * total_rounds, seconds);
+}
+
+// The sorted acid_list the priority list replaces: inserts walk from the front and all
+// consumers pop the first node.
+struct SortedListQueue {
+    struct task {
+        int64_t priority;
+        int64_t value;
+    };
+
+    void insert(int64_t priority, int64_t value) {
+        list.insert_sorted(task{priority, value}, [](const task& lhs, const task& rhs) {
+            return lhs.priority < rhs.priority;
+        });
+    }
+
+    std::optional<task> delete_min() {
+        return list.try_pop_front();
+    }
+
+    polyndrom::acid_list<task> list;
+};
+
+void BenchScheduler() {
+    for (size_t threads_count : {1, 4, 16}) {
+        SortedListQueue sorted;
+        MeasureScheduler("scheduler/sorted_list", threads_count, sorted);
+        polyndrom::concurrent_priority_list<int64_t, int64_t> strict(polyndrom::delete_mode::strict);
+        MeasureScheduler("scheduler/strict", threads_count, strict);
+        polyndrom::concurrent_priority_list<int64_t, int64_t> relaxed(polyndrom::delete_mode::relaxed, 8);
+        MeasureScheduler("scheduler/relaxed_8", threads_count, relaxed);
+    }
+}
+
+const std::map<std::string, Benchmark>& Benchmarks() {
+    static const std::map<std::string, Benchmark> benchmarks = {
+        {"push_back", BenchPushBack},
+        {"scan", BenchScan},
+        {"numa", BenchNumaPlacement},
+        {"cold_start", BenchColdStart},
+        {"sliding_window", BenchSlidingWindow},
+        {"soa_scan", BenchSoaScan},
+        {"aggregates", BenchAggregates},
+        {"lru", BenchLru},
+        {"partition", BenchPartition},
+        {"contention", BenchContention},
+        {"arena", BenchArena},
+        {"scheduler", BenchScheduler},
+        {"history", BenchHistory},
+        {"weak", BenchWeakIterators},
+    };
+    return benchmarks;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto& benchmarks = Benchmarks();
+    if (argc == 1) {
+        for (const auto& [name, benchmark] : benchmarks) {
+            benchmark();
+        }
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        auto it = benchmarks.find(argv[i]);
+        if (it == benchmarks.end()) {
+            std::cerr << "unknown benchmark: " << argv[i] << std::endl;
+            return 1;
+        }
+        it->second();
+    }
+    return 0;
+}
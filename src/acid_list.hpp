@@ -2,40 +2,148 @@
 
 #include "fwd.hpp"
 #include "list_node.hpp"
+#include "link_protocol.hpp"
 #include "list_iterator.hpp"
+#include "borrowed_iterator.hpp"
+#include "weak_iterator.hpp"
+#include "type_stable_allocator.hpp"
+#include "serialization.hpp"
+#include "list_awaiters.hpp"
+#include "soa_arena.hpp"
+#include "simd_kernels.hpp"
+#include "list_capacity.hpp"
+#include "threading_policy.hpp"
+#include "contention_policy.hpp"
+#include "intrusive_list.hpp"
+#include "work_partition.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <functional>
 #include <utility>
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
+#include <optional>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace polyndrom {
 
-template<class T>
+struct reclamation_stats {
+    size_t nodes = 0;
+    size_t bytes = 0;
+};
+
+// A position in the history of an acid_list, see acid_list::checkpoint().
+struct history_checkpoint {
+    size_t position = 0;
+
+    auto operator<=>(const history_checkpoint&) const = default;
+};
+
+template<class T, class Policy, class Allocator>
 class acid_list {
+public:
+    using policy_type = Policy;
+    using allocator_type = Allocator;
+
 private:
-    using self_type = acid_list<T>;
+    using self_type = acid_list<T, Policy, Allocator>;
     using node_ptr = detail::consistent_node_ptr<self_type>;
+    using link_protocol = detail::link_protocol<node_ptr>;
+
+    template<class U>
+    using atomic = typename Policy::template atomic<U>;
+
+    template<class U, class OtherPolicy, class OtherAllocator>
+    friend class acid_list;
 
     friend node_ptr;
     friend list_iterator<self_type>;
+    friend borrowed_iterator<self_type>;
+    friend borrow_scope<self_type>;
+    friend nonempty_awaiter<self_type>;
+    friend pop_front_awaiter<self_type>;
+    friend insert_awaiter<self_type>;
+    friend work_partition<self_type>;
 
-    using read_lock = std::shared_lock<std::shared_mutex>;
-    using write_lock = std::unique_lock<std::shared_mutex>;
+    using read_lock = std::shared_lock<typename Policy::mutex_type>;
+    using write_lock = std::unique_lock<typename Policy::mutex_type>;
 
 public:
     using value_type = T;
     using iterator = list_iterator<self_type>;
+    // Available if the list allocates with type_stable_allocator, see type_stable_list.
+    using weak_iterator = polyndrom::weak_iterator<self_type>;
+
+    acid_list() : acid_list(numa_policy{}) {
+    }
 
-    acid_list() : first(T()), last(T()) {
+    // Nodes, sentinels included, are allocated with a copy of allocator rebound to the node
+    // type. The NUMA placement is only honoured with the default allocator.
+    explicit acid_list(const Allocator& allocator) : acid_list(numa_policy{}, {}, allocator) {
+    }
+
+    explicit acid_list(numa_policy placement, contention_policy contention = {}, const Allocator& allocator = Allocator())
+        : first(numa_policy{}, allocator, T()), last(numa_policy{}, allocator, T()),
+          allocator(allocator), placement(placement), contention(contention) {
         first->next = last;
         last->prev = first;
     }
 
+    explicit acid_list(contention_policy contention, const Allocator& allocator = Allocator())
+        : acid_list(numa_policy{}, contention, allocator) {
+    }
+
+    // Takes over the elements of a list with another threading policy, along with its
+    // capacity limit. Node types differ between policies, so each value is moved into a new
+    // node; other is left empty.
+    template<class OtherPolicy>
+    explicit acid_list(acid_list<T, OtherPolicy, Allocator>&& other) requires (!std::is_same_v<OtherPolicy, Policy>)
+        : acid_list(other.placement, other.contention, other.allocator) {
+        max_elements = other.max_elements;
+        on_overflow = other.on_overflow;
+        node_chain chain;
+        while (std::optional<T> value = other.try_pop_front()) {
+            chain.append(make_node(std::move(*value)));
+        }
+        charge(chain.length);
+        insert_chain(last, chain);
+    }
+
+    // Bounded list: push_back, push_front and insert wait for room or drop the oldest
+    // elements according to the capacity's overflow policy, their try_ variants fail instead.
+    // replace_range and load are not held back, so they may leave the list over capacity
+    // until enough elements are erased.
+    explicit acid_list(list_capacity capacity, numa_policy placement = {}, contention_policy contention = {},
+                       const Allocator& allocator = Allocator())
+        : acid_list(placement, contention, allocator) {
+        max_elements = capacity.element_limit(sizeof(typename node_ptr::consistent_node));
+        on_overflow = capacity.on_overflow;
+    }
+
     template<typename U>
     void push_back(U&& value) {
         insert(last, std::forward<U>(value));
     }
 
+    template<typename U>
+    bool try_push_back(U&& value) {
+        return try_insert(end(), std::forward<U>(value)).has_value();
+    }
+
     template<typename U>
     void push_front(U&& value) {
         insert(first.locked_read_next(), std::forward<U>(value));
@@ -43,13 +151,146 @@ public:
 
     template<typename U>
     iterator insert(iterator pos, U&& value) {
-        node_ptr node = insert(pos.node, std::forward<U>(value));
-        return iterator(node);
+        return iterator(insert(pos.node, std::forward<U>(value)));
+    }
+
+    template<typename U>
+    std::optional<iterator> try_insert(iterator pos, U&& value) {
+        if (!try_admit(1)) {
+            return std::nullopt;
+        }
+        node_chain chain(make_admitted_node(std::forward<U>(value)));
+        node_ptr new_node = chain.head.share_unpublished();
+        insert_chain(pos.node, chain);
+        return iterator(std::move(new_node));
+    }
+
+    template<std::input_iterator InputIt>
+    iterator insert(iterator pos, InputIt values_begin, InputIt values_end) {
+        node_chain chain = make_chain(values_begin, values_end);
+        if (chain.length == 0) {
+            return pos;
+        }
+        admit(chain.length);
+        node_ptr head = chain.head.share_unpublished();
+        insert_chain(pos.node, chain);
+        return iterator(std::move(head));
+    }
+
+    // Inserts value before the first element that compares greater than it, so a list kept
+    // ordered by comp stays ordered and equal elements stay in insertion order. The search
+    // starts at hint if it is live and doesn't compare greater than value, and at the front
+    // otherwise. The position is checked again with both neighbours write-locked, and the
+    // search resumes from the predecessor if they changed meanwhile.
+    template<typename U, class Compare = std::less<>>
+    iterator insert_sorted(const iterator& hint, U&& value, Compare comp = Compare()) {
+        return iterator(insert_sorted(hint.node, std::forward<U>(value), comp));
+    }
+
+    template<typename U, class Compare = std::less<>>
+        requires std::predicate<Compare&, const T&, const T&>
+    iterator insert_sorted(U&& value, Compare comp = Compare()) {
+        return iterator(insert_sorted(first, std::forward<U>(value), comp));
     }
 
     iterator erase(iterator pos) {
-        node_ptr node = erase_node(pos.node);
-        return iterator(node);
+        return iterator(erase_node(pos.node));
+    }
+
+    // Erases [range_begin, range_end) in a single step: the window is locked once, left to
+    // right, and the whole segment is unlinked at once. The erased nodes keep their links, so
+    // iterators inside the window move on to range_end.
+    iterator erase(iterator range_begin, iterator range_end) {
+        node_chain chain;
+        return iterator(replace_nodes(range_begin.node, range_end.node, chain));
+    }
+
+    // Replaces [range_begin, range_end) with the given values in a single step. Returns an
+    // iterator to the first inserted element, or to range_end if no values were given.
+    template<std::input_iterator InputIt>
+    iterator replace_range(iterator range_begin, iterator range_end, InputIt values_begin, InputIt values_end) {
+        node_chain chain = make_chain(values_begin, values_end);
+        return iterator(replace_nodes(range_begin.node, range_end.node, chain));
+    }
+
+    // Moves element before pos by relinking its node, so nothing is allocated and iterators
+    // to the element follow it. Iterators walking the list meanwhile may visit the element
+    // twice or not at all. Returns false if the element has been erased.
+    bool splice(const iterator& pos, const iterator& element) {
+        return link_protocol::relink(element.node, pos.node, contention);
+    }
+
+    static constexpr bool has_lock_free_values = detail::is_lock_free_value<T>();
+
+    // Applies fn to the element in place. Other writers of the element are excluded: for
+    // lock-free value types fn runs on a copy that is published with a compare-exchange and
+    // may be invoked several times, otherwise it runs once under the node's write lock.
+    template<class Fn>
+    void update(const iterator& pos, Fn fn) {
+        if constexpr (has_lock_free_values) {
+            std::atomic_ref<T> value(pos.node->value);
+            T expected = value.load();
+            T desired;
+            do {
+                desired = expected;
+                fn(desired);
+            } while (!value.compare_exchange_weak(expected, desired));
+        } else {
+            write_lock lock(pos.node->mutex);
+            fn(pos.node->value);
+        }
+    }
+
+    T load(const iterator& pos) const requires has_lock_free_values {
+        return std::atomic_ref<T>(pos.node->value).load();
+    }
+
+    void store(const iterator& pos, T desired) requires has_lock_free_values {
+        std::atomic_ref<T>(pos.node->value).store(desired);
+    }
+
+    bool compare_exchange(const iterator& pos, T& expected, T desired) requires has_lock_free_values {
+        return std::atomic_ref<T>(pos.node->value).compare_exchange_strong(expected, desired);
+    }
+
+    T fetch_add(const iterator& pos, T arg) requires has_lock_free_values && std::is_arithmetic_v<T> {
+        return std::atomic_ref<T>(pos.node->value).fetch_add(arg);
+    }
+
+    // Erases the first element and returns its value, or nothing if the list is empty.
+    // Iterators still pointing at the erased node observe a moved-from value.
+    std::optional<T> try_pop_front() {
+        while (true) {
+            node_ptr node = first.locked_read_next();
+            if (node == last) {
+                return std::nullopt;
+            }
+            if (std::optional<T> value = try_extract_node(node)) {
+                return value;
+            }
+        }
+    }
+
+    // Erases the element at pos, which must not be end(), and returns its value, or nothing
+    // if it has already been erased: of the threads extracting the same element, one gets it.
+    std::optional<T> try_extract(const iterator& pos) {
+        return try_extract_node(pos.node);
+    }
+
+    // co_await list.async_pop_front() suspends until an element can be popped and yields it.
+    // Suspended coroutines aren't resumed by the destructor, which requires there be none.
+    pop_front_awaiter<self_type> async_pop_front() {
+        return pop_front_awaiter<self_type>(*this);
+    }
+
+    // co_await list.wait_nonempty() suspends while the list is empty.
+    nonempty_awaiter<self_type> wait_nonempty() {
+        return nonempty_awaiter<self_type>(*this);
+    }
+
+    // co_await list.on_insert() suspends until the next insertion into the list.
+    insert_awaiter<self_type> on_insert() {
+        return insert_awaiter<self_type>(*this);
     }
 
     iterator begin() const {
@@ -60,76 +301,1247 @@ public:
         return iterator(last);
     }
 
+    // Iterator to the last element, or nothing if the list is empty.
+    std::optional<iterator> try_back() const {
+        node_ptr node = last.locked_read_prev();
+        if (node == first) {
+            return std::nullopt;
+        }
+        return iterator(std::move(node));
+    }
+
+    // Opens a scope for refcount-free traversal, see borrow_scope.
+    borrow_scope<self_type> borrow() const {
+        return borrow_scope<self_type>(*this);
+    }
+
+    // Hand-over-hand traversal: fn(value) runs while the element and its successor are
+    // read-locked, so neither can be unlinked and deleted nodes are never visited. The lock
+    // on an element is released only after the one following it is taken, and the node two
+    // steps ahead is prefetched while fn runs. No reference counts are touched on the way.
+    template<class Fn>
+    void traverse(Fn fn) const {
+        traverse(begin(), end(), fn);
+    }
+
+    // Traverses [range_begin, range_end). If range_end is erased while the traversal is in
+    // progress, the traversal continues to the end of the list.
+    template<class Fn>
+    void traverse(const iterator& range_begin, const iterator& range_end, Fn fn) const {
+        traverse_nodes(range_begin.node, range_end.node.get(), [&fn](const auto* node) {
+            fn(read_value(node));
+            return true;
+        });
+    }
+
+    // Calls fn(std::span<const T>) with copies of up to batch_size consecutive elements of
+    // [range_begin, range_end) at a time. A batch is collected within one hand-over-hand
+    // traversal like traverse's, and fn runs with no locks held; between batches only the
+    // node to resume from is referenced. Each element is visited at most once, and every
+    // element that stays in the list for the whole call is visited. As with traverse, if
+    // range_end is erased meanwhile the traversal continues to the end of the list.
+    template<class Fn>
+    void for_each_batch(const iterator& range_begin, const iterator& range_end, size_t batch_size, Fn fn) const {
+        std::vector<T> values(std::max<size_t>(batch_size, 1));
+        node_ptr position = range_begin.node;
+        while (position != nullptr) {
+            size_t count = 0;
+            node_ptr resume;
+            traverse_nodes(std::move(position), range_end.node.get(), [&](auto* node) {
+                values[count++] = read_value(node);
+                if (count == values.size()) {
+                    // node and its successor are read-locked.
+                    resume = node->next;
+                    return false;
+                }
+                return true;
+            });
+            position = std::move(resume);
+            if (count != 0) {
+                fn(std::span<const T>(values.data(), count));
+            }
+        }
+    }
+
+    // Like for_each_batch, from the last element of [range_begin, range_end) to the first;
+    // each batch is in that order too. Locks can't be taken right to left without risking
+    // a deadlock with writers, so predecessors are only try-locked. When that fails the
+    // locks are dropped and collection goes on from the last visited node, which is kept
+    // referenced, after backing off as the list's contention_policy says. As with traverse,
+    // if range_begin is erased the range starts at its first live successor, which is found
+    // again whenever it is erased during the traversal.
+    template<class Fn>
+    void reverse_for_each_batch(const iterator& range_begin, const iterator& range_end, size_t batch_size, Fn fn) const {
+        std::vector<T> values(std::max<size_t>(batch_size, 1));
+        node_ptr stop = range_begin.node;
+        node_ptr anchor = range_end.node;
+        bool anchor_visited = false;
+        size_t count = 0;
+        detail::backoff wait(contention);
+        while (true) {
+            // Erased nodes keep their links, so this finds the successor stop had when erased.
+            while (stop->is_deleted) {
+                stop = stop.locked_read_next();
+            }
+            bool done = stop == range_end.node || (anchor_visited && anchor == stop);
+            anchor->mutex.lock_shared();
+            if (!done && anchor->is_deleted) {
+                // The first live node before the erased one takes its place and is visited.
+                node_ptr erased = anchor;
+                do {
+                    node_ptr prev = anchor->prev;
+                    anchor->mutex.unlock_shared();
+                    anchor = std::move(prev);
+                    anchor->mutex.lock_shared();
+                } while (anchor->is_deleted);
+                if (stop->is_deleted) {
+                    // The range may start after the node landed on, so that is decided again.
+                    anchor->mutex.unlock_shared();
+                    anchor = std::move(erased);
+                    continue;
+                }
+                if (anchor == first) {
+                    done = true;
+                } else {
+                    values[count++] = read_value(anchor.get());
+                    anchor_visited = true;
+                    done = anchor == stop;
+                }
+            }
+
+            // As in traverse_locked, a node is kept linked by a read lock on its successor,
+            // except for the anchor, which is referenced instead. stop can't be erased while
+            // its successor is locked, so checking it before every step keeps the walk
+            // from going past it.
+            auto* node = anchor.get();
+            decltype(node) successor = nullptr;
+            bool contended = false;
+            bool moved_stop = false;
+            while (!done && count < values.size()) {
+                if (stop->is_deleted) {
+                    moved_stop = true;
+                    break;
+                }
+                auto* prev = node->prev.get();
+                if (prev == first.get()) {
+                    done = true;
+                    break;
+                }
+                if (!prev->mutex.try_lock_shared()) {
+                    contended = true;
+                    break;
+                }
+                if (node->is_deleted) {
+                    // The anchor was erased before its predecessor got locked.
+                    prev->mutex.unlock_shared();
+                    contended = true;
+                    break;
+                }
+                if (successor != nullptr) {
+                    successor->mutex.unlock_shared();
+                }
+                successor = node;
+                node = prev;
+                values[count++] = read_value(node);
+                done = node == stop.get();
+            }
+            if (successor != nullptr) {
+                anchor = successor->prev;
+                anchor_visited = true;
+                successor->mutex.unlock_shared();
+            }
+            node->mutex.unlock_shared();
+
+            if (moved_stop) {
+                continue;
+            }
+            if (contended) {
+                wait();
+                continue;
+            }
+            if (count != 0) {
+                fn(std::span<const T>(values.data(), count));
+                count = 0;
+            }
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    // Splits a traversal among workers_count threads, which then balance it by stealing
+    // work from each other, see work_partition. Waits for the list's previous partition to
+    // be destroyed, so a thread must not call it while holding one of the same list.
+    work_partition<self_type> partition(size_t workers_count) const {
+        return work_partition<self_type>(*this, workers_count);
+    }
+
+    // Aggregates over arithmetic elements. Values are copied out in batches by the
+    // hand-over-hand traversal and reduced with vector kernels. The result accounts for
+    // every element that is in the list for the whole call and for no element that is
+    // absent for the whole call; elements inserted or erased during the call may or may
+    // not be accounted for. Every element is accounted for at most once.
+
+    // First element equal to value. A match is reported only if the element is still in
+    // the list once the batch containing it has been reduced.
+    iterator find(const T& value) const requires std::is_arithmetic_v<T> {
+        node_ptr anchor;
+        for_each_value_batch([&anchor, &value](const T* values, size_t count, const node_ptr& batch_anchor) {
+            if (detail::find_equal(values, count, value) == count) {
+                return true;
+            }
+            anchor = batch_anchor;
+            return false;
+        });
+        if (anchor == nullptr) {
+            return end();
+        }
+        // The batch is walked again from its first node, which may have been erased since.
+        iterator it(std::move(anchor));
+        if (it.node->is_deleted) {
+            ++it;
+        }
+        // Values are read like the batches read them, as update() may be writing them.
+        for (; it != end(); ++it) {
+            bool found;
+            if constexpr (has_lock_free_values) {
+                found = read_value(it.node.get()) == value;
+            } else {
+                read_lock lock(it.node->mutex);
+                found = read_value(it.node.get()) == value;
+            }
+            if (found) {
+                return it;
+            }
+        }
+        return end();
+    }
+
+    size_t count(const T& value) const requires std::is_arithmetic_v<T> {
+        size_t result = 0;
+        for_each_value_batch([&result, &value](const T* values, size_t count, const node_ptr&) {
+            result += detail::count_equal(values, count, value);
+            return true;
+        });
+        return result;
+    }
+
+    std::optional<T> min() const requires std::is_arithmetic_v<T> {
+        std::optional<T> result;
+        for_each_value_batch([&result](const T* values, size_t count, const node_ptr&) {
+            T batch_min = detail::min_value(values, count);
+            result = result.has_value() ? std::min(*result, batch_min) : batch_min;
+            return true;
+        });
+        return result;
+    }
+
+    std::optional<T> max() const requires std::is_arithmetic_v<T> {
+        std::optional<T> result;
+        for_each_value_batch([&result](const T* values, size_t count, const node_ptr&) {
+            T batch_max = detail::max_value(values, count);
+            result = result.has_value() ? std::max(*result, batch_max) : batch_max;
+            return true;
+        });
+        return result;
+    }
+
+    T sum() const requires std::is_arithmetic_v<T> {
+        T result = 0;
+        for_each_value_batch([&result](const T* values, size_t count, const node_ptr&) {
+            result = static_cast<T>(result + detail::sum_values(values, count));
+            return true;
+        });
+        return result;
+    }
+
+    // Values of a single linearizable state of the list: the traversal keeps every visited
+    // node read-locked until the end is reached, so writers touching the already visited
+    // prefix wait and the result is exactly the content at that moment.
+    std::vector<T> snapshot() const {
+        std::vector<T> values;
+        values.reserve(size());
+        for_each_in_snapshot([&values](const T& value) {
+            values.push_back(value);
+        });
+        return values;
+    }
+
+    // Writes a snapshot() as a header followed by the raw values in a single write.
+    void serialize(std::ostream& os) const requires std::is_trivially_copyable_v<T> {
+        std::vector<std::byte> buffer = serialize_snapshot();
+        os.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    void serialize(int fd) const requires std::is_trivially_copyable_v<T> {
+        std::vector<std::byte> buffer = serialize_snapshot();
+        detail::write_all(fd, buffer.data(), buffer.size());
+    }
+
+    // Appends the values of a serialized snapshot. The nodes are chained up privately and
+    // published with a single link operation, without any per-element locking.
+    void load(const std::string& path) requires std::is_trivially_copyable_v<T> {
+        detail::file_descriptor file(path);
+        load(file.fd);
+    }
+
+    void load(int fd) requires std::is_trivially_copyable_v<T> {
+        detail::mapped_file file(fd);
+        if (file.size < sizeof(detail::snapshot_header)) {
+            throw std::runtime_error("acid_list snapshot: truncated header");
+        }
+        detail::snapshot_header header;
+        std::memcpy(&header, file.data, sizeof(header));
+        header.validate(sizeof(T), max_loaded_count);
+        header.validate_payload(file.size - sizeof(header));
+        node_chain chain;
+        const std::byte* data = file.data + sizeof(header);
+        for (uint64_t i = 0; i < header.count; i++, data += sizeof(T)) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            chain.append(make_node(value));
+        }
+        charge(chain.length);
+        insert_chain(last, chain);
+    }
+
+    void load(std::istream& is) requires std::is_trivially_copyable_v<T> {
+        detail::snapshot_header header;
+        if (!is.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("acid_list snapshot: truncated header");
+        }
+        // A short payload shows as a failed read; the count only has to fit the list.
+        header.validate(sizeof(T), max_loaded_count);
+        node_chain chain;
+        std::vector<T> buffer(std::min<uint64_t>(header.count, 4096));
+        for (uint64_t loaded = 0; loaded < header.count; loaded += buffer.size()) {
+            buffer.resize(std::min<uint64_t>(header.count - loaded, buffer.size()));
+            if (!is.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(T)))) {
+                throw std::runtime_error("acid_list snapshot: truncated payload");
+            }
+            for (const T& value : buffer) {
+                chain.append(make_node(value));
+            }
+        }
+        charge(chain.length);
+        insert_chain(last, chain);
+    }
+
+    allocator_type get_allocator() const {
+        return allocator;
+    }
+
+    numa_policy node_placement() const {
+        return placement;
+    }
+
+    contention_policy contention_handling() const {
+        return contention;
+    }
+
     int size() const {
         return elements_count;
     }
 
+    // Erased elements whose nodes are still kept alive by iterators, or by other erased nodes
+    // that are. The count is kept per node type, so it sums over all lists of this type.
+    static reclamation_stats unreclaimed_of_type() {
+        size_t nodes = node_ptr::unreclaimed_count();
+        return {nodes, nodes * sizeof(typename node_ptr::consistent_node)};
+    }
+
+    // While enabled, erased nodes that are still referenced are recorded so that compact()
+    // can reach them. A record keeps its node alive until the next compact(), or until it is
+    // found to be the node's last reference as the records grow.
+    void track_erased(bool enabled) {
+        erased_tracking = enabled;
+        if (!enabled) {
+            std::vector<node_ptr> records;
+            std::lock_guard lock(erased_mutex);
+            records.swap(erased_records);
+        }
+    }
+
+    // Redirects the links of recorded erased nodes that are still referenced from elsewhere
+    // to their nearest live neighbours and forgets all other records. An erased node pinned
+    // by a stale iterator then keeps only itself alive instead of every node erased after
+    // it. Returns the number of erased nodes that are still pinned.
+    size_t compact() {
+        std::lock_guard compact_lock(compact_mutex);
+        std::vector<node_ptr> records;
+        {
+            std::lock_guard lock(erased_mutex);
+            records.swap(erased_records);
+        }
+        std::vector<node_ptr> pinned;
+        for (node_ptr& node : records) {
+            if (node->ref_count > 1) {
+                // Rolling back relinks erased nodes next to the neighbours they were erased from.
+                if (!history_tracking) {
+                    redirect_to_live(node);
+                }
+                pinned.push_back(std::move(node));
+            }
+        }
+        records.clear();
+        // Nodes that were only pinned by other erased nodes are released now.
+        std::erase_if(pinned, [](const node_ptr& node) {
+            return node->ref_count == 1;
+        });
+        size_t pinned_count = pinned.size();
+        std::lock_guard lock(erased_mutex);
+        std::move(pinned.begin(), pinned.end(), std::back_inserter(erased_records));
+        return pinned_count;
+    }
+
+    // While enabled, insertions and erasures are appended to a history log that refers to
+    // the nodes themselves, so that the list can be rolled back to a checkpoint. The log
+    // keeps the erased nodes it refers to alive, without copying their values, until it is
+    // truncated past them. Values taken out with try_pop_front or try_extract are copied
+    // rather than moved while the log is kept, so they are intact when rolled back. Moves
+    // made with splice aren't logged. Enabling and disabling starts an empty log.
+    void track_history(bool enabled) {
+        std::vector<history_record> records;
+        std::lock_guard lock(history_mutex);
+        history_tracking = enabled;
+        history_base += history_records.size();
+        records.swap(history_records);
+    }
+
+    history_checkpoint checkpoint() const {
+        std::lock_guard lock(history_mutex);
+        return {history_base + history_records.size()};
+    }
+
+    // Undoes the logged changes made after checkpoint, newest first: inserted elements are
+    // erased and erased ones are linked back after the element they followed, so iterators
+    // to them are valid again. Nothing else may change the list meanwhile. Throws
+    // std::out_of_range if the log has been truncated past checkpoint.
+    void rollback_to(history_checkpoint checkpoint) {
+        std::vector<history_record> undone;
+        {
+            std::lock_guard lock(history_mutex);
+            if (checkpoint.position < history_base || checkpoint.position > history_base + history_records.size()) {
+                throw std::out_of_range("acid_list: checkpoint is not in the history");
+            }
+            auto from = history_records.begin() + static_cast<std::ptrdiff_t>(checkpoint.position - history_base);
+            undone.assign(std::make_move_iterator(from), std::make_move_iterator(history_records.end()));
+            history_records.erase(from, history_records.end());
+        }
+        for (auto record = undone.rbegin(); record != undone.rend(); ++record) {
+            if (record->inserted) {
+                unlink_node(record->node, false);
+            } else {
+                revive_node(record->node);
+            }
+        }
+    }
+
+    // Forgets the log before checkpoint, releasing the erased nodes only it kept alive. The
+    // list can't be rolled back past checkpoint afterwards.
+    void truncate_history(history_checkpoint checkpoint) {
+        std::vector<history_record> truncated;
+        std::lock_guard lock(history_mutex);
+        size_t count = std::min(checkpoint.position, history_base + history_records.size()) - std::min(checkpoint.position, history_base);
+        auto end = history_records.begin() + static_cast<std::ptrdiff_t>(count);
+        truncated.assign(std::make_move_iterator(history_records.begin()), std::make_move_iterator(end));
+        history_records.erase(history_records.begin(), end);
+        history_base += count;
+    }
+
+    // Number of logged changes.
+    size_t history_size() const {
+        std::lock_guard lock(history_mutex);
+        return history_records.size();
+    }
+
+    // Element limit of a bounded list, zero if the list is unbounded.
+    size_t capacity() const {
+        return max_elements;
+    }
+
     void clear() {
         for (auto it = begin(); it != end(); it = erase(it));
     }
 
+    // Empties the list without destroying or deallocating any element node, for lists whose
+    // allocator is about to release all of its memory at once, like a
+    // std::pmr::monotonic_buffer_resource that is reset after a request. Element destructors
+    // don't run and the nodes are never returned to the allocator. The sentinels are kept,
+    // with the links the abandoned nodes had to them dropped, and released by the
+    // destructor, so the list must be destroyed before the memory is released. Nothing else
+    // may use the list during the call, and iterators into it must be gone by then too.
+    void discard() {
+        if (first->next != last) {
+            first->next->prev = nullptr;
+            last->prev->next = nullptr;
+            first->next.abandon();
+            last->prev.abandon();
+            first->next = last;
+            last->prev = first;
+        }
+        std::vector<typename node_ptr::consistent_node*> abandoned;
+        {
+            std::lock_guard lock(erased_mutex);
+            for (node_ptr& node : erased_records) {
+                abandoned.push_back(node.get());
+                node.abandon();
+            }
+            erased_records.clear();
+        }
+        {
+            std::lock_guard lock(history_mutex);
+            for (history_record& record : history_records) {
+                abandoned.push_back(record.node.get());
+                record.node.abandon();
+            }
+            history_records.clear();
+        }
+        uncount_abandoned(std::move(abandoned));
+        release(static_cast<size_t>(elements_count.exchange(0)));
+    }
+
+    // No coroutine may still be suspended on the list: it would be left holding a dangling
+    // reference, so the list must outlive every async_pop_front(), wait_nonempty() and
+    // on_insert() awaiting it. Debug builds assert that none is parked.
     ~acid_list() {
+        assert(insert_waiters.empty() && nonempty_waiters.empty());
+        track_history(false);
         clear();
         first->next = nullptr;
         last->prev = nullptr;
     }
 
 private:
+    static T& value_of(const node_ptr& node) {
+        return node->value;
+    }
+
+    // Nodes linked to each other but not yet reachable from the list. Unless handed over to
+    // insert_chain, the links are broken on destruction so the nodes don't keep each other alive.
+    struct node_chain {
+        node_ptr head = nullptr;
+        node_ptr tail = nullptr;
+        int length = 0;
+
+        node_chain() = default;
+
+        explicit node_chain(node_ptr node) : head(node.share_unpublished()), tail(std::move(node)), length(1) {
+        }
+
+        void append(node_ptr node) {
+            if (length++ == 0) {
+                head = node.share_unpublished();
+                tail = std::move(node);
+                return;
+            }
+            node->prev = tail.share_unpublished();
+            tail->next = node.share_unpublished();
+            tail = std::move(node);
+        }
+
+        ~node_chain() {
+            node_ptr node = std::move(head);
+            while (node != nullptr) {
+                node_ptr next = std::move(node->next);
+                node->prev = nullptr;
+                node = std::move(next);
+            }
+        }
+    };
+
+    // A change in the history log: node was inserted, or erased if not.
+    struct history_record {
+        node_ptr node;
+        bool inserted = false;
+    };
+
+    // Erased nodes are counted as unreclaimed until they are disposed of, which abandoned
+    // ones never are. Erased nodes only link to each other, to live ones and to the
+    // sentinels, so the erased nodes abandoned along with the records are the ones reachable
+    // from them. Their links to the sentinels are dropped, as they would never be.
+    template<class Node>
+    void uncount_abandoned(std::vector<Node*> pending) {
+        std::unordered_set<const Node*> seen;
+        auto drop_sentinel = [this](node_ptr& link) {
+            if (link == first || link == last) {
+                link = nullptr;
+            }
+        };
+        while (!pending.empty()) {
+            Node* node = pending.back();
+            pending.pop_back();
+            if (node == nullptr || !node->is_deleted || !seen.insert(node).second) {
+                continue;
+            }
+            pending.push_back(node->prev.get());
+            pending.push_back(node->next.get());
+            drop_sentinel(node->prev);
+            drop_sentinel(node->next);
+        }
+        node_ptr::uncount_erased(seen.size());
+    }
+
+    template<typename U>
+    node_ptr make_node(U&& value) const {
+        return node_ptr(placement, allocator, std::forward<U>(value));
+    }
+
+    template<class InputIt>
+    node_chain make_chain(InputIt values_begin, InputIt values_end) {
+        node_chain chain;
+        for (; values_begin != values_end; ++values_begin) {
+            chain.append(make_node(*values_begin));
+        }
+        return chain;
+    }
+
+    // Gives the admitted room back if the value can't be constructed.
+    template<typename U>
+    node_ptr make_admitted_node(U&& value) {
+        try {
+            return make_node(std::forward<U>(value));
+        } catch (...) {
+            release(1);
+            throw;
+        }
+    }
+
     template<typename U>
-    node_ptr insert(node_ptr node, U&& value) {
-        node_ptr new_node(std::forward<U>(value));
+    node_ptr insert(const node_ptr& pos, U&& value) {
+        admit(1);
+        node_chain chain(make_admitted_node(std::forward<U>(value)));
+        node_ptr new_node = chain.head.share_unpublished();
+        insert_chain(pos, chain);
+        return new_node;
+    }
+
+    void insert_chain(const node_ptr& pos, node_chain& chain) {
+        if (chain.length == 0) {
+            return;
+        }
+        // link_before hands the chain's head over to the list.
+        node_ptr head = history_tracking ? chain.head.share_unpublished() : nullptr;
+        link_protocol::link(pos, chain, [this, &chain, &head] {
+            log_inserted(head, chain.length);
+            elements_count += chain.length;
+            chain.length = 0;
+        }, contention);
+        notify_inserted();
+    }
+
+    template<typename U, class Compare>
+    node_ptr insert_sorted(node_ptr start, U&& value, Compare& comp) {
+        admit(1);
+        node_chain chain(make_admitted_node(std::forward<U>(value)));
+        node_ptr new_node = chain.head.share_unpublished();
+        const T& inserted = new_node->value;
+        // Whether node may stay in front of the inserted element.
+        auto precedes = [&](const auto* node) {
+            return node == first.get() || !comp(inserted, read_value(node));
+        };
+        auto can_start_from = [&](const node_ptr& node) {
+            if (node == first) {
+                return true;
+            }
+            if (node == last) {
+                return false;
+            }
+            read_lock lock(node->mutex);
+            return !node->is_deleted && precedes(node.get());
+        };
+
+        for (detail::backoff wait(contention);; wait()) {
+            if (!can_start_from(start)) {
+                start = first;
+            }
+            node_ptr prev;
+            node_ptr next;
+            traverse_nodes(start == first ? first.locked_read_next() : std::move(start), last.get(), [&](auto* node) {
+                if (precedes(node)) {
+                    return true;
+                }
+                // node and its successor are read-locked, so both links of node are current.
+                next = node->next->prev;
+                prev = node->prev;
+                return false;
+            });
+            if (next == nullptr) {
+                next = last;
+                prev = last.locked_read_prev();
+            }
+            bool linked = link_protocol::try_link_between(prev, next, chain, [&] {
+                return precedes(prev.get()) && (next == last || !precedes(next.get()));
+            }, [this, &chain, &new_node] {
+                log_inserted(new_node, chain.length);
+                elements_count += chain.length;
+                chain.length = 0;
+            });
+            if (linked) {
+                notify_inserted();
+                return new_node;
+            }
+            start = std::move(prev);
+        }
+    }
+
+    // Calls visit(node) for the nodes of [node, stop) until it returns false. Deleted nodes
+    // at the start are skipped by following their links, holding a reference on the way, as
+    // compact() may redirect the links of deleted nodes.
+    template<class Node, class Visit>
+    void traverse_nodes(node_ptr node, const Node* stop, Visit visit) const {
         while (true) {
-            while (node->is_deleted) {
-                node = node.locked_read_next();
+            node->mutex.lock_shared();
+            if (node == last) {
+                node->mutex.unlock_shared();
+                return;
+            }
+            auto* next = node->next.get();
+            next->mutex.lock_shared();
+            if (!node->is_deleted) {
+                break;
             }
+            node_ptr successor = node->next;
+            next->mutex.unlock_shared();
+            node->mutex.unlock_shared();
+            node = std::move(successor);
+        }
+        traverse_locked(node.get(), stop, visit);
+    }
 
-            node_ptr prev = node.locked_read_prev();
+    // node and its successor are read-locked, which keeps node linked: erasing it would need
+    // a write lock on the successor.
+    template<class Node, class Visit>
+    void traverse_locked(Node* node, const Node* stop, Visit& visit) const {
+        // Drops the locks however the walk ends, including by visit() throwing.
+        struct unlock_guard {
+            Node*& node;
+            const Node* last;
 
-            write_lock prev_lock(prev->mutex);
-            write_lock current_lock(node->mutex);
+            ~unlock_guard() {
+                if (node == last) {
+                    node->mutex.unlock_shared();
+                    return;
+                }
+                // Erasing a node only read-locks it, so once either lock is dropped the other
+                // node may be unlinked and released; node is referenced until both are unlocked.
+                node_ptr pinned = node->next->prev;
+                node->next->mutex.unlock_shared();
+                node->mutex.unlock_shared();
+            }
+        } guard{node, last.get()};
+        while (node != stop && node != last.get()) {
+            auto* next = node->next.get();
+            if (next != last.get()) {
+                auto* ahead = next->next.get();
+                detail::prefetch(ahead);
+                detail::prefetch(&ahead->value);
+            }
+            if (!visit(node)) {
+                break;
+            }
+            if (next != last.get()) {
+                next->next->mutex.lock_shared();
+            }
+            node->mutex.unlock_shared();
+            node = next;
+        }
+    }
 
-            if (node->is_deleted || node->prev != prev) {
-                continue;
+    // Element updates of lock-free types don't take the node lock, so their values are read
+    // atomically, into a copy; other values are read in place under the node's lock.
+    template<class Node>
+    static decltype(auto) read_value(Node* node) {
+        if constexpr (has_lock_free_values) {
+            return std::atomic_ref<T>(const_cast<T&>(node->value)).load(std::memory_order_relaxed);
+        } else {
+            return std::as_const(node->value);
+        }
+    }
+
+    static constexpr size_t value_batch_size = 256;
+
+    // elements_count is an int.
+    static constexpr uint64_t max_loaded_count = std::numeric_limits<int>::max();
+
+    // Copies values out in batches and calls fn(values, count, anchor), where anchor is the
+    // first node of the batch, until fn returns false.
+    template<class Fn>
+    void for_each_value_batch(Fn fn) const {
+        T values[value_batch_size];
+        size_t count = 0;
+        node_ptr anchor;
+        bool proceed = true;
+        traverse_nodes(first.locked_read_next(), last.get(), [&](auto* node) {
+            if (count == 0) {
+                // node and its successor are read-locked, so the successor links back to node.
+                anchor = node->next->prev;
+            }
+            values[count++] = read_value(node);
+            if (count == value_batch_size) {
+                proceed = fn(values, count, anchor);
+                count = 0;
             }
+            return proceed;
+        });
+        if (proceed && count != 0) {
+            fn(values, count, anchor);
+        }
+    }
 
-            new_node->prev = prev;
-            new_node->next = node;
-            prev->next = new_node;
-            node->prev = new_node;
-            ++elements_count;
-            return new_node;
+    // Read-locks nodes left to right and keeps them locked until the end is reached. Lock order
+    // matches the writers', and a locked node can't be unlinked while its successor is locked.
+    template<class Fn>
+    void for_each_in_snapshot(Fn fn) const {
+        for_each_node_in_snapshot([&fn](const auto* node) {
+            fn(read_value(node));
+        });
+    }
+
+    template<class Visit>
+    void for_each_node_in_snapshot(Visit visit) const {
+        struct unlock_guard {
+            const node_ptr& first;
+            typename node_ptr::consistent_node* locked_last = nullptr;
+
+            // Right to left: a node can't be unlinked while its predecessor is still locked,
+            // whereas unlocking from the left would let the last node go while it is locked.
+            ~unlock_guard() {
+                auto* node = locked_last;
+                while (node != nullptr) {
+                    auto* prev = node == first.get() ? nullptr : node->prev.get();
+                    node->mutex.unlock_shared();
+                    node = prev;
+                }
+            }
+        } guard{first};
+        first->mutex.lock_shared();
+        guard.locked_last = first.get();
+        for (auto* node = first->next.get(); node != last.get(); node = node->next.get()) {
+            node->mutex.lock_shared();
+            guard.locked_last = node;
+            visit(node);
         }
     }
 
-    node_ptr erase_node(node_ptr node) {
-        while (!node->is_deleted) {
-            auto [prev, next] = node.locked_read_nodes();
+    // Requires partition_mutex. Claim marks are only compared for equality, so when the pass
+    // number wraps, the marks left from earlier passes are cleared before any is reused.
+    uint32_t next_partition_pass() const {
+        if (++partition_pass == 0) {
+            for_each_node_in_snapshot([](auto* node) {
+                node->claim_mark = 0;
+            });
+            ++partition_pass;
+        }
+        return partition_pass;
+    }
 
-            write_lock prev_lock(prev->mutex);
-            read_lock current_lock(node->mutex);
-            write_lock next_lock(next->mutex);
+    std::vector<std::byte> serialize_snapshot() const {
+        std::vector<std::byte> buffer(sizeof(detail::snapshot_header));
+        buffer.reserve(sizeof(detail::snapshot_header) + size() * sizeof(T));
+        size_t count = 0;
+        for_each_in_snapshot([&buffer, &count](const T& value) {
+            const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+            ++count;
+        });
+        auto header = detail::snapshot_header::make(sizeof(T), count);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        return buffer;
+    }
 
-            if (node->is_deleted) {
-                return last;
+    // Unlinks [from, to) and links chain in its place while holding write locks on the window
+    // and the nodes around it, taken left to right once. The erased nodes are left linked as
+    // if they had been erased one by one from the left: each points back to the window's
+    // predecessor and forward to its old successor, so the removed segment holds no
+    // reference cycles and is released as a chain once the last iterator into it is gone.
+    // Returns the first node after the replaced window.
+    node_ptr replace_nodes(node_ptr from, node_ptr to, node_chain& chain) {
+        for (detail::backoff wait(contention);; wait()) {
+            while (from->is_deleted) {
+                from = from.locked_read_next();
+            }
+            while (to->is_deleted) {
+                to = to.locked_read_next();
+            }
+            auto replace_empty_range = [&] {
+                node_ptr head = chain.length == 0 ? to : chain.head;
+                charge(static_cast<size_t>(chain.length));
+                insert_chain(to, chain);
+                return head;
+            };
+            if (from == to) {
+                return replace_empty_range();
             }
 
-            if (node->prev != prev || node->next != next) {
+            node_ptr prev = from.locked_read_prev();
+
+            write_lock prev_lock(prev->mutex);
+            std::vector<write_lock> window_locks;
+            window_locks.emplace_back(from->mutex);
+            if (from->is_deleted || from->prev != prev) {
                 continue;
             }
+            auto* node = from.get();
+            while (node->next != to && node->next != last) {
+                node = node->next.get();
+                window_locks.emplace_back(node->mutex);
+            }
+            if (node->next != to) {
+                if (to->is_deleted) {
+                    continue;
+                }
+                // to is live but not after from, e.g. inserted before the erased node that
+                // from was skipped on from: the range is empty.
+                window_locks.clear();
+                prev_lock.unlock();
+                return replace_empty_range();
+            }
+            write_lock to_lock(to->mutex);
 
-            node->is_deleted = true;
-            next->prev = prev;
-            prev->next = next;
+            int erased_count = 0;
+            std::vector<node_ptr> erased;
+            for (const node_ptr* current = &from; *current != to; current = &(*current)->next) {
+                node = current->get();
+                node->is_deleted = true;
+                if (node != from.get()) {
+                    node->prev = prev;
+                }
+                if (erased_tracking) {
+                    erased.push_back(*current);
+                }
+                log_change(*current, false);
+                ++erased_count;
+            }
+            node_ptr::count_erased(static_cast<size_t>(erased_count));
+            elements_count -= erased_count;
+            int inserted_count = chain.length;
+            node_ptr head = to;
+            if (chain.length == 0) {
+                prev->next = to;
+                to->prev = std::move(prev);
+            } else {
+                head = chain.head;
+                log_inserted(head, chain.length);
+                chain.head->prev = prev;
+                chain.tail->next = to;
+                prev->next = std::move(chain.head);
+                to->prev = std::move(chain.tail);
+                elements_count += chain.length;
+                chain.length = 0;
+            }
+            to_lock.unlock();
+            window_locks.clear();
+            prev_lock.unlock();
+            if (erased_count > inserted_count) {
+                release(static_cast<size_t>(erased_count - inserted_count));
+            } else {
+                charge(static_cast<size_t>(inserted_count - erased_count));
+            }
+            record_erased(erased);
+            if (head != to) {
+                notify_inserted();
+            }
+            return head;
+        }
+    }
+
+    node_ptr erase_node(node_ptr node) {
+        return try_erase_node(std::move(node)).value_or(last);
+    }
+
+    // Returns the successor of the erased node, or nothing if it was already erased.
+    std::optional<node_ptr> try_erase_node(node_ptr node) {
+        return unlink_node(std::move(node), true);
+    }
+
+    std::optional<node_ptr> unlink_node(node_ptr node, bool logged) {
+        std::optional<node_ptr> next = link_protocol::try_unlink(node, [this, &node, logged] {
+            node_ptr::count_erased(1);
             --elements_count;
-            return next;
+            if (logged) {
+                log_change(node, false);
+            }
+        }, contention);
+        // A node nothing else refers to is released on return and needs no record.
+        if (next) {
+            release(1);
+            if (erased_tracking && node->ref_count > 1) {
+                record_erased(std::move(node));
+            }
+        }
+        return next;
+    }
+
+    std::optional<T> try_extract_node(const node_ptr& node) {
+        if (!try_erase_node(node)) {
+            return std::nullopt;
+        }
+        write_lock lock(node->mutex);
+        if constexpr (has_lock_free_values) {
+            return read_value(node.get());
+        } else if constexpr (std::is_copy_constructible_v<T>) {
+            if (history_tracking) {
+                return node->value;
+            }
+        }
+        return std::move(node->value);
+    }
+
+    // Links an erased node back after its predecessor from when it was erased, or after the
+    // nearest live node before that one.
+    void revive_node(const node_ptr& node) {
+        node_ptr prev = node.locked_read_prev();
+        bool revived = link_protocol::try_revive(node, std::move(prev), [this, &node] {
+            // A mark left from before the partition pass wrapped would read as a claim.
+            node->claim_mark = 0;
+            node_ptr::uncount_erased(1);
+            ++elements_count;
+        }, contention);
+        if (revived) {
+            charge(1);
+            notify_inserted();
+        }
+    }
+
+    // Called with the neighbours of the changed nodes still locked, so that the log orders
+    // changes to adjacent nodes the way they happened.
+    void log_change(const node_ptr& node, bool inserted) {
+        if (history_tracking) {
+            std::lock_guard lock(history_mutex);
+            history_records.push_back({node, inserted});
+        }
+    }
+
+    void log_inserted(const node_ptr& head, int length) {
+        if (!history_tracking || head == nullptr) {
+            return;
+        }
+        std::lock_guard lock(history_mutex);
+        const node_ptr* node = &head;
+        for (int i = 0; i < length; i++, node = &(*node)->next) {
+            history_records.push_back({*node, true});
         }
-        return last;
+    }
+
+    // Occupancy is tracked only by bounded lists. It counts admitted elements, including the
+    // ones not linked yet, so that concurrent producers can't overshoot the capacity.
+    bool try_admit(size_t count) {
+        if (max_elements == 0) {
+            return true;
+        }
+        size_t current = occupancy.load();
+        do {
+            if (current + count > max_elements) {
+                return false;
+            }
+        } while (!occupancy.compare_exchange_weak(current, current + count));
+        return true;
+    }
+
+    void admit(size_t count) {
+        if (try_admit(count)) {
+            return;
+        }
+        if (count > max_elements) {
+            throw std::length_error("acid_list: insertion exceeds capacity");
+        }
+        if (!Policy::is_concurrent && on_overflow == overflow_policy::block) {
+            // No other thread can make room.
+            throw std::length_error("acid_list: single-threaded list is full");
+        }
+        while (!try_admit(count)) {
+            if (on_overflow == overflow_policy::drop_oldest) {
+                drop_oldest();
+            } else {
+                wait_for_room(count);
+            }
+        }
+    }
+
+    // A parked producer's increment of parked_producers and a release's decrement of
+    // occupancy are ordered like Dekker's flags: either the producer sees the room or the
+    // release sees the producer and wakes it up.
+    void wait_for_room(size_t count) {
+        parked_producers.fetch_add(1);
+        size_t current = occupancy.load();
+        if (current + count > max_elements) {
+            occupancy.wait(current);
+        }
+        parked_producers.fetch_sub(1);
+    }
+
+    void drop_oldest() {
+        node_ptr node = first.locked_read_next();
+        if (node == last) {
+            // Everything admitted is still being linked.
+            std::this_thread::yield();
+            return;
+        }
+        try_erase_node(node);
+    }
+
+    void charge(size_t count) {
+        if (max_elements != 0) {
+            occupancy += count;
+        }
+    }
+
+    void release(size_t count) {
+        if (max_elements == 0) {
+            return;
+        }
+        occupancy -= count;
+        if (parked_producers.load() != 0) {
+            occupancy.notify_all();
+        }
+    }
+
+    void record_erased(node_ptr node) {
+        std::unique_lock lock(erased_mutex);
+        erased_records.push_back(std::move(node));
+        prune_erased_records(lock);
+    }
+
+    void record_erased(std::vector<node_ptr>& erased) {
+        if (erased.empty()) {
+            return;
+        }
+        std::unique_lock lock(erased_mutex);
+        std::move(erased.begin(), erased.end(), std::back_inserter(erased_records));
+        prune_erased_records(lock);
+    }
+
+    // Whenever the records have doubled since the last pass, only those of nodes referenced
+    // from outside the records are kept: by more than their own record and the links of other
+    // recorded nodes. compact() releases the nodes reached only through the links of those,
+    // so the records grow with the pinned nodes rather than with every erasure. The dropped
+    // nodes are released unlocked.
+    void prune_erased_records(std::unique_lock<std::mutex>& lock) {
+        if (erased_records.size() < erased_prune_size) {
+            return;
+        }
+        std::unordered_map<const void*, size_t> linked;
+        for (const node_ptr& node : erased_records) {
+            read_lock node_lock(node->mutex);
+            ++linked[node->prev.get()];
+            ++linked[node->next.get()];
+        }
+        auto unpinned = std::partition(erased_records.begin(), erased_records.end(), [&linked](const node_ptr& node) {
+            auto links = linked.find(node.get());
+            return node->ref_count > 1 + (links == linked.end() ? 0 : links->second);
+        });
+        std::vector<node_ptr> dropped(std::make_move_iterator(unpinned), std::make_move_iterator(erased_records.end()));
+        erased_records.erase(unpinned, erased_records.end());
+        erased_prune_size = std::max(2 * erased_records.size(), min_erased_prune_size);
+        lock.unlock();
+    }
+
+    // Links of erased nodes are changed only here, under compact_mutex, so the new neighbours
+    // are found before the node is locked and no other lock is held while it is.
+    void redirect_to_live(const node_ptr& node) {
+        auto [prev, next] = node.locked_read_nodes();
+        while (prev->is_deleted) {
+            prev = prev.locked_read_prev();
+        }
+        while (next->is_deleted) {
+            next = next.locked_read_next();
+        }
+        write_lock lock(node->mutex);
+        node->prev = std::move(prev);
+        node->next = std::move(next);
+    }
+
+    void notify_inserted() {
+        if (!insert_waiters.empty()) {
+            detail::list_waiter* waiter = insert_waiters.take_all();
+            while (waiter != nullptr) {
+                detail::list_waiter* next = waiter->next;
+                waiter->handle.resume();
+                waiter = next;
+            }
+        }
+        if (!nonempty_waiters.empty()) {
+            resume_nonempty_waiters();
+        }
+    }
+
+    // A waiter that can't complete is pushed back. Its push and an inserter's increment of
+    // elements_count are ordered like Dekker's flags, so a retry is needed only when
+    // elements are still there after a waiter was pushed back.
+    void resume_nonempty_waiters() {
+        bool pushed_back = true;
+        while (pushed_back && size() > 0) {
+            pushed_back = false;
+            detail::list_waiter* waiter = nonempty_waiters.take_all();
+            while (waiter != nullptr) {
+                detail::list_waiter* next = waiter->next;
+                if (waiter->try_complete(waiter)) {
+                    waiter->handle.resume();
+                } else {
+                    nonempty_waiters.push(waiter);
+                    pushed_back = true;
+                }
+                waiter = next;
+            }
+        }
+    }
+
+    // Called from await_suspend: the waiter may be resumed right away, before this returns.
+    void suspend_until_nonempty(detail::list_waiter* waiter) {
+        nonempty_waiters.push(waiter);
+        if (size() > 0) {
+            resume_nonempty_waiters();
+        }
+    }
+
+    void suspend_until_insert(detail::list_waiter* waiter) {
+        insert_waiters.push(waiter);
     }
 
 private:
     node_ptr first;
     node_ptr last;
-    std::atomic_int elements_count = 0;
+    [[no_unique_address]] Allocator allocator;
+    numa_policy placement;
+    contention_policy contention;
+    atomic<int> elements_count = 0;
+    size_t max_elements = 0;
+    overflow_policy on_overflow = overflow_policy::block;
+    atomic<size_t> occupancy = 0;
+    atomic<size_t> parked_producers = 0;
+    atomic<bool> erased_tracking = false;
+    std::mutex erased_mutex;
+    std::vector<node_ptr> erased_records;
+    static constexpr size_t min_erased_prune_size = 64;
+    size_t erased_prune_size = min_erased_prune_size;
+    std::mutex compact_mutex;
+    atomic<bool> history_tracking = false;
+    mutable std::mutex history_mutex;
+    size_t history_base = 0;
+    std::vector<history_record> history_records;
+    mutable std::mutex partition_mutex;
+    mutable uint32_t partition_pass = 0;
+    mutable atomic<std::thread::id> partition_owner;
+    detail::waiter_stack insert_waiters;
+    detail::waiter_stack nonempty_waiters;
 };
 
+// List whose payloads live in a soa_arena shared by its elements, for example
+// list.push_back(arena.make(key, weight)). The nodes only hold the record references.
+template<class... Fields>
+using soa_list = acid_list<soa_record<Fields...>>;
+
+// List whose positions can be kept as weak_iterators. Its nodes are never returned to the
+// system, only reused by lists of the same type.
+template<class T, class Policy = multi_thread_policy>
+using type_stable_list = acid_list<T, Policy, type_stable_allocator<T>>;
+
+namespace pmr {
+
+template<class T, class Policy = multi_thread_policy>
+using acid_list = polyndrom::acid_list<T, Policy, std::pmr::polymorphic_allocator<T>>;
+
+} // pmr
+
 } // polyndrom
\ No newline at end of file
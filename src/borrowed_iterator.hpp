@@ -0,0 +1,155 @@
+#pragma once
+
+#include "fwd.hpp"
+#include "list_node.hpp"
+#include "list_iterator.hpp"
+
+#include <iterator>
+
+namespace polyndrom {
+
+// Iterator that refers to nodes by raw pointer and never touches reference counts. It is
+// only valid while the borrow_scope it was obtained from is alive: the scope defers the
+// destruction of every node of this list type, which keeps the traversed chain intact.
+template<typename List>
+class borrowed_iterator {
+private:
+    using list_type = List;
+
+    friend borrow_scope<list_type>;
+
+    using read_lock = typename list_type::read_lock;
+    using node_ptr = detail::consistent_node_ptr<List>;
+    using node_type = typename node_ptr::consistent_node;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename list_type::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    borrowed_iterator() = default;
+
+    value_type& operator*() const {
+        read_lock lock(node->mutex);
+        return node->value;
+    }
+
+    value_type* operator->() const {
+        read_lock lock(node->mutex);
+        return &(node->value);
+    }
+
+    borrowed_iterator& operator++() {
+        node = read_next(node);
+        while (node->is_deleted) {
+            node = read_next(node);
+        }
+        return *this;
+    }
+
+    borrowed_iterator operator++(int) {
+        borrowed_iterator other(*this);
+        ++*this;
+        return other;
+    }
+
+    borrowed_iterator& operator--() {
+        node = read_prev(node);
+        while (node->is_deleted) {
+            node = read_prev(node);
+        }
+        return *this;
+    }
+
+    borrowed_iterator operator--(int) {
+        borrowed_iterator other(*this);
+        --*this;
+        return other;
+    }
+
+    bool operator==(const borrowed_iterator& rhs) const {
+        return node == rhs.node;
+    }
+
+    bool operator!=(const borrowed_iterator& rhs) const {
+        return node != rhs.node;
+    }
+
+    // Makes the position durable. If the node was erased and nothing but this borrowed
+    // iterator refers to it anymore, the owning iterator is placed on the next node that
+    // is still referenced, which is where incrementing from the erased node would lead.
+    explicit operator list_iterator<list_type>() const {
+        node_ptr owned;
+        node_type* current = node;
+        while (!owned.try_acquire(current)) {
+            current = read_next(current);
+        }
+        return list_iterator<list_type>(std::move(owned));
+    }
+
+private:
+    explicit borrowed_iterator(node_type* node) : node(node) {
+    }
+
+    static node_type* read_next(node_type* node) {
+        read_lock lock(node->mutex);
+        return node->next.get();
+    }
+
+    static node_type* read_prev(node_type* node) {
+        read_lock lock(node->mutex);
+        return node->prev.get();
+    }
+
+private:
+    node_type* node = nullptr;
+};
+
+// Scoped guard under which borrowed iterators may be used. While any scope is open, nodes
+// of this list type whose last reference goes away are queued instead of deleted and are
+// reclaimed when the last scope closes, so scopes should be kept short.
+template<typename List>
+class borrow_scope {
+private:
+    using list_type = List;
+
+    friend list_type;
+
+    using read_lock = typename list_type::read_lock;
+    using node_ptr = detail::consistent_node_ptr<List>;
+
+public:
+    using iterator = borrowed_iterator<list_type>;
+
+    borrow_scope(const borrow_scope&) = delete;
+    borrow_scope& operator=(const borrow_scope&) = delete;
+
+    iterator begin() const {
+        read_lock lock(list.first->mutex);
+        return iterator(list.first->next.get());
+    }
+
+    iterator end() const {
+        return iterator(list.last.get());
+    }
+
+    iterator borrow(const list_iterator<list_type>& it) const {
+        return iterator(it.node.get());
+    }
+
+    ~borrow_scope() {
+        node_ptr::exit_borrow();
+    }
+
+private:
+    explicit borrow_scope(const list_type& list) : list(list) {
+        node_ptr::enter_borrow();
+    }
+
+private:
+    const list_type& list;
+};
+
+} // polyndrom
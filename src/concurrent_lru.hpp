@@ -0,0 +1,185 @@
+#pragma once
+
+#include "acid_list.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace polyndrom {
+
+// Least recently used cache keeping its entries in an acid_list, most recent first. Keys
+// map to list iterators through a striped hash index: operations on different stripes don't
+// contend and lookups on the same stripe share its lock. A hit moves the entry to the front
+// by relinking its node, but only once the entry has fallen behind by a quarter of the
+// capacity since it was last placed there, so that hot entries don't keep the head of the
+// list locked. Eviction runs on one thread at a time and, once the cache overflows, removes
+// a batch of entries from the tail.
+template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+class concurrent_lru {
+public:
+    struct statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    // The number of stripes is rounded up to a power of two.
+    explicit concurrent_lru(size_t capacity, size_t stripes_count = 64)
+        : max_size(std::max<size_t>(capacity, 1)),
+          eviction_batch(std::max<size_t>(max_size / 32, 1)),
+          promotion_distance(std::max<size_t>(max_size / 4, 1)),
+          stripes(std::bit_ceil(std::max<size_t>(stripes_count, 1))) {
+    }
+
+    concurrent_lru(const concurrent_lru&) = delete;
+    concurrent_lru& operator=(const concurrent_lru&) = delete;
+
+    std::optional<V> get(const K& key) {
+        stripe& owner = stripe_for(key);
+        std::shared_lock lock(owner.mutex);
+        auto found = owner.index.find(key);
+        if (found == owner.index.end()) {
+            owner.misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        // Values are only written under the stripe's exclusive lock.
+        std::optional<V> value(found->second->value);
+        touch(found->second);
+        owner.hits.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    // Inserts the entry or replaces its value, making it the most recent one.
+    void put(const K& key, V value) {
+        {
+            stripe& owner = stripe_for(key);
+            std::unique_lock lock(owner.mutex);
+            auto found = owner.index.find(key);
+            if (found != owner.index.end()) {
+                found->second->value = std::move(value);
+                touch(found->second);
+                return;
+            }
+            iterator it = entries.insert(entries.begin(), entry{key, std::move(value), clock.fetch_add(1)});
+            owner.index.emplace(key, std::move(it));
+        }
+        if (size() > max_size) {
+            evict();
+        }
+    }
+
+    bool erase(const K& key) {
+        stripe& owner = stripe_for(key);
+        std::unique_lock lock(owner.mutex);
+        auto found = owner.index.find(key);
+        if (found == owner.index.end()) {
+            return false;
+        }
+        entries.erase(found->second);
+        owner.index.erase(found);
+        return true;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(entries.size());
+    }
+
+    size_t capacity() const {
+        return max_size;
+    }
+
+    statistics stats() const {
+        statistics result;
+        for (const stripe& owner : stripes) {
+            result.hits += owner.hits.load(std::memory_order_relaxed);
+            result.misses += owner.misses.load(std::memory_order_relaxed);
+        }
+        result.evictions = evictions.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    struct entry {
+        K key;
+        V value;
+        // Value of the clock when the entry was last placed at the front.
+        alignas(std::atomic_ref<uint64_t>::required_alignment) uint64_t stamp;
+    };
+
+    using list_type = acid_list<entry>;
+    using iterator = typename list_type::iterator;
+
+    struct alignas(64) stripe {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<K, iterator, Hash, KeyEqual> index;
+        std::atomic_size_t hits = 0;
+        std::atomic_size_t misses = 0;
+    };
+
+    stripe& stripe_for(const K& key) {
+        uint64_t hash = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return stripes[(hash ^ (hash >> 32)) & (stripes.size() - 1)];
+    }
+
+    // The clock counts placements at the front, so the distance between the clock and an
+    // entry's stamp bounds how far from the front the entry can be. Of the threads hitting
+    // the same entry, the one that wins the stamp exchange moves it.
+    void touch(iterator& it) {
+        std::atomic_ref<uint64_t> stamp(it->stamp);
+        uint64_t last_placed = stamp.load(std::memory_order_relaxed);
+        uint64_t now = clock.load(std::memory_order_relaxed);
+        if (now - last_placed < promotion_distance) {
+            return;
+        }
+        if (!stamp.compare_exchange_strong(last_placed, now, std::memory_order_relaxed)) {
+            return;
+        }
+        if (entries.splice(entries.begin(), it)) {
+            clock.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Evicts from the tail down to eviction_batch - 1 entries below the capacity. An entry is
+    // dropped from the index and the list under its stripe's lock, like by erase.
+    void evict() {
+        std::unique_lock lock(eviction_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        while (size() > max_size + 1 - eviction_batch) {
+            std::optional<iterator> victim = entries.try_back();
+            if (!victim) {
+                return;
+            }
+            const K& key = (*victim)->key;
+            stripe& owner = stripe_for(key);
+            std::unique_lock stripe_lock(owner.mutex);
+            auto found = owner.index.find(key);
+            if (found != owner.index.end() && found->second == *victim) {
+                entries.erase(found->second);
+                owner.index.erase(found);
+                evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t max_size;
+    const size_t eviction_batch;
+    const size_t promotion_distance;
+    list_type entries;
+    std::vector<stripe> stripes;
+    std::atomic<uint64_t> clock = 0;
+    std::mutex eviction_mutex;
+    std::atomic_size_t evictions = 0;
+};
+
+} // polyndrom
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace polyndrom {
+
+enum class backoff_strategy {
+    // Retry right away.
+    none,
+    // Spin on pause instructions for a jittered number of rounds that doubles with every
+    // failed attempt, up to max_spins.
+    exponential,
+    // Exponential, then yield the thread once the spins are capped, and then sleep.
+    escalating
+};
+
+// What an acid_list does when a writer finds its nodes changed under it after locking them
+// and has to start over. Retrying at once takes the same locks back while the writer that
+// got there first is still working around them; waiting lets it finish. Lists made without
+// a policy escalate, so a writer that keeps failing ends up sleeping for park_time between
+// attempts; latency-sensitive lists can opt for exponential or none.
+struct contention_policy {
+    backoff_strategy strategy = backoff_strategy::escalating;
+    uint32_t min_spins = 4;
+    uint32_t max_spins = 1024;
+    // Escalating only: failed attempts that yield once spinning is capped, before the
+    // remaining ones sleep for park_time.
+    uint32_t yields = 4;
+    std::chrono::microseconds park_time{20};
+
+    static contention_policy none() {
+        return {backoff_strategy::none};
+    }
+
+    static contention_policy exponential(uint32_t min_spins = 4, uint32_t max_spins = 1024) {
+        return {backoff_strategy::exponential, min_spins, max_spins};
+    }
+
+    static contention_policy escalating(uint32_t yields = 4, std::chrono::microseconds park_time = std::chrono::microseconds(20)) {
+        return {backoff_strategy::escalating, 4, 1024, yields, park_time};
+    }
+};
+
+namespace detail {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Per-thread xorshift, so that threads failing on the same nodes retry at different times.
+inline uint32_t backoff_jitter() {
+    thread_local uint32_t state = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Waiting state of one retry loop, called after every failed attempt with all locks dropped.
+// Returns how it waited.
+class backoff {
+public:
+    enum class step {
+        none,
+        spin,
+        yield,
+        sleep
+    };
+
+    explicit backoff(const contention_policy& policy) : policy(policy), spins(std::max<uint32_t>(policy.min_spins, 1)) {
+    }
+
+    step operator()() {
+        switch (policy.strategy) {
+            case backoff_strategy::none:
+                return step::none;
+            case backoff_strategy::exponential:
+                spin();
+                return step::spin;
+            case backoff_strategy::escalating:
+                if (!spins_capped) {
+                    spin();
+                    return step::spin;
+                }
+                if (yields < policy.yields) {
+                    ++yields;
+                    std::this_thread::yield();
+                    return step::yield;
+                }
+                std::this_thread::sleep_for(policy.park_time);
+                return step::sleep;
+        }
+        return step::none;
+    }
+
+private:
+    void spin() {
+        uint32_t rounds = spins / 2 + backoff_jitter() % (spins / 2 + 1);
+        for (uint32_t i = 0; i < rounds; ++i) {
+            cpu_relax();
+        }
+        spins_capped = spins >= policy.max_spins;
+        spins = std::max<uint32_t>(std::min(spins * 2, policy.max_spins), 1);
+    }
+
+    const contention_policy& policy;
+    uint32_t spins;
+    uint32_t yields = 0;
+    bool spins_capped = false;
+};
+
+} // detail
+
+} // polyndrom
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 namespace polyndrom {
 
 namespace detail {
@@ -12,7 +14,27 @@ class consistent_node_ptr;
 template<typename List>
 class list_iterator;
 
-template<class T>
+template<typename List>
+class borrowed_iterator;
+
+template<typename List>
+class borrow_scope;
+
+template<typename List>
+class weak_iterator;
+
+template<class List>
+class work_partition;
+
+struct multi_thread_policy;
+
+template<class T, class Policy = multi_thread_policy, class Allocator = std::allocator<T>>
 class acid_list;
 
+template<class Policy>
+class intrusive_hook;
+
+template<class T, auto Hook>
+class intrusive_list;
+
 } // polyndrom
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "fwd.hpp"
+#include "link_protocol.hpp"
+#include "threading_policy.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stack>
+#include <utility>
+
+namespace polyndrom {
+
+namespace detail {
+
+// Counted pointer to an intrusive_hook. When the last reference to a hook is dropped its
+// links are released, which may cascade to its neighbours like for acid_list nodes. Hooks
+// embedded in user objects are then handed back to their owner; list sentinels, which
+// belong to no object, are deleted.
+template<class Policy>
+class intrusive_hook_ptr {
+public:
+    using hook_type = intrusive_hook<Policy>;
+    using read_lock = std::shared_lock<typename Policy::mutex_type>;
+
+    intrusive_hook_ptr() = default;
+
+    intrusive_hook_ptr(std::nullptr_t) {
+    }
+
+    explicit intrusive_hook_ptr(hook_type* hook) {
+        acquire(hook);
+    }
+
+    intrusive_hook_ptr(const intrusive_hook_ptr& other) {
+        acquire(other.hook);
+    }
+
+    intrusive_hook_ptr(intrusive_hook_ptr&& other) noexcept : hook(std::exchange(other.hook, nullptr)) {
+    }
+
+    intrusive_hook_ptr& operator=(const intrusive_hook_ptr& other) {
+        if (hook == other.hook) {
+            return *this;
+        }
+        hook_type* new_hook = other.hook;
+        release();
+        acquire(new_hook);
+        return *this;
+    }
+
+    intrusive_hook_ptr& operator=(intrusive_hook_ptr&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        hook = std::exchange(other.hook, nullptr);
+        return *this;
+    }
+
+    intrusive_hook_ptr& operator=(std::nullptr_t) {
+        release();
+        return *this;
+    }
+
+    ~intrusive_hook_ptr() {
+        release();
+    }
+
+    hook_type* operator->() const {
+        return hook;
+    }
+
+    hook_type* get() const {
+        return hook;
+    }
+
+    bool operator==(const intrusive_hook_ptr& rhs) const {
+        return hook == rhs.hook;
+    }
+
+    bool operator!=(const intrusive_hook_ptr& rhs) const {
+        return hook != rhs.hook;
+    }
+
+    intrusive_hook_ptr locked_read_next() const {
+        read_lock lock(hook->mutex);
+        return hook->next;
+    }
+
+    intrusive_hook_ptr locked_read_prev() const {
+        read_lock lock(hook->mutex);
+        return hook->prev;
+    }
+
+    std::pair<intrusive_hook_ptr, intrusive_hook_ptr> locked_read_nodes() const {
+        read_lock lock(hook->mutex);
+        return {hook->prev, hook->next};
+    }
+
+    // Takes a reference only if the hook is still referenced by someone else, so a hook
+    // whose links are being released is not brought back.
+    bool try_acquire(hook_type* other) {
+        release();
+        size_t count = other->ref_count.load();
+        while (count != 0) {
+            if (other->ref_count.compare_exchange_weak(count, count + 1)) {
+                hook = other;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void acquire(hook_type* other) {
+        hook = other;
+        if (hook != nullptr) {
+            hook->ref_count += 1;
+        }
+    }
+
+    void release() {
+        if (hook != nullptr) {
+            if (hook->ref_count-- == 1) {
+                unlink_released(hook);
+            }
+            hook = nullptr;
+        }
+    }
+
+    static void unlink_released(hook_type* root) {
+        hooks_stack.push(root);
+        while (!hooks_stack.empty()) {
+            hook_type* released = hooks_stack.top();
+            hooks_stack.pop();
+            hook_type* prev = std::exchange(released->prev.hook, nullptr);
+            hook_type* next = std::exchange(released->next.hook, nullptr);
+            if (prev != nullptr && prev->ref_count-- == 1) {
+                hooks_stack.push(prev);
+            }
+            if (next != nullptr && next->ref_count-- == 1) {
+                hooks_stack.push(next);
+            }
+            if (released->owner == nullptr) {
+                delete released;
+            } else {
+                released->in_use_flag.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    static thread_local std::stack<hook_type*> hooks_stack;
+    hook_type* hook = nullptr;
+};
+
+template<class Policy>
+thread_local std::stack<intrusive_hook<Policy>*> intrusive_hook_ptr<Policy>::hooks_stack{};
+
+} // detail
+
+// Links embedded into objects that are kept in intrusive_lists: an object has one hook per
+// list it can be a member of. The hook holds the same fields as an acid_list node apart
+// from the value, so linking and unlinking the object never allocates.
+template<class Policy = multi_thread_policy>
+class intrusive_hook {
+public:
+    using policy_type = Policy;
+
+    intrusive_hook() = default;
+
+    intrusive_hook(const intrusive_hook&) = delete;
+    intrusive_hook& operator=(const intrusive_hook&) = delete;
+
+    // Whether the object is in a list through this hook, or was erased from one but is still
+    // referenced by iterators or by other erased objects. The object may be destroyed or
+    // inserted again through this hook only once the hook is no longer in use.
+    bool in_use() const {
+        return in_use_flag.load(std::memory_order_acquire);
+    }
+
+private:
+    friend detail::intrusive_hook_ptr<Policy>;
+
+    template<class T, auto Hook>
+    friend class intrusive_list;
+
+    template<class List>
+    friend class list_iterator;
+
+    template<class NodePtr>
+    friend struct detail::link_protocol;
+
+    template<class U>
+    using atomic = typename Policy::template atomic<U>;
+
+    detail::intrusive_hook_ptr<Policy> prev = nullptr;
+    detail::intrusive_hook_ptr<Policy> next = nullptr;
+    // The object embedding the hook, null for list sentinels.
+    void* owner = nullptr;
+    // The list the hook was last inserted into, checked by erase(T&) and iterator_to() in
+    // debug builds.
+    const void* list = nullptr;
+    atomic<size_t> ref_count = 0;
+    atomic<bool> is_deleted = false;
+    // Hooks are handed back to their owner by whichever thread drops the last reference,
+    // so this flag is atomic under every policy.
+    std::atomic<bool> in_use_flag = false;
+    typename Policy::mutex_type mutex;
+};
+
+} // polyndrom
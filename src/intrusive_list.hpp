@@ -0,0 +1,190 @@
+#pragma once
+
+#include "fwd.hpp"
+#include "contention_policy.hpp"
+#include "intrusive_hook.hpp"
+#include "link_protocol.hpp"
+#include "list_iterator.hpp"
+
+#include <cassert>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace polyndrom {
+
+namespace detail {
+
+template<class MemberPointer>
+struct hook_member;
+
+template<class T, class Policy>
+struct hook_member<intrusive_hook<Policy> T::*> {
+    using object_type = T;
+    using policy_type = Policy;
+};
+
+} // detail
+
+// List of user-owned objects linked through the intrusive_hook member Hook of T, e.g.
+// intrusive_list<task, &task::queue_hook>. Objects are linked and unlinked with the same
+// protocol as acid_list nodes and iterators have the same semantics: an iterator keeps the
+// object it points to reachable after it is erased and moves on to the next live object.
+// Nothing is allocated on insertion or erasure; the objects must outlive their use by the
+// list, see intrusive_hook::in_use().
+template<class T, auto Hook>
+class intrusive_list {
+    using member = detail::hook_member<decltype(Hook)>;
+    static_assert(std::is_same_v<typename member::object_type, T>);
+
+public:
+    using policy_type = typename member::policy_type;
+    using hook_type = intrusive_hook<policy_type>;
+
+private:
+    using self_type = intrusive_list<T, Hook>;
+    using node_ptr = detail::intrusive_hook_ptr<policy_type>;
+    using link_protocol = detail::link_protocol<node_ptr>;
+
+    friend list_iterator<self_type>;
+
+    using read_lock = std::shared_lock<typename policy_type::mutex_type>;
+    using write_lock = std::unique_lock<typename policy_type::mutex_type>;
+
+public:
+    using value_type = T;
+    using iterator = list_iterator<self_type>;
+
+    explicit intrusive_list(contention_policy contention = {})
+        : first(new hook_type), last(new hook_type), contention(contention) {
+        first->next = last;
+        last->prev = first;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    // Insertion throws std::invalid_argument if the object's hook is in use.
+
+    void push_back(T& object) {
+        insert(last, object);
+    }
+
+    void push_front(T& object) {
+        insert(first.locked_read_next(), object);
+    }
+
+    iterator insert(iterator pos, T& object) {
+        return iterator(insert(pos.node, object));
+    }
+
+    iterator erase(iterator pos) {
+        return iterator(try_erase_node(pos.node).value_or(last));
+    }
+
+    // Erases an object of this list. Returns false if it has been erased already. The object
+    // must have been inserted into this list, not into another list through the same hook;
+    // this is only checked in debug builds.
+    bool erase(T& object) {
+        node_ptr node;
+        if (!node.try_acquire(&(object.*Hook))) {
+            return false;
+        }
+        assert(node->list == this);
+        return try_erase_node(node).has_value();
+    }
+
+    // Iterator to an object of this list, or end() if it has been erased. Like erase(T&),
+    // the object must have been inserted into this list.
+    iterator iterator_to(T& object) const {
+        node_ptr node;
+        if (!node.try_acquire(&(object.*Hook))) {
+            return end();
+        }
+        assert(node->list == this);
+        if (node->is_deleted) {
+            return end();
+        }
+        return iterator(std::move(node));
+    }
+
+    // Erases the first object and returns it, or nullptr if the list is empty.
+    T* try_pop_front() {
+        while (true) {
+            node_ptr node = first.locked_read_next();
+            if (node == last) {
+                return nullptr;
+            }
+            if (try_erase_node(node)) {
+                return &value_of(node);
+            }
+        }
+    }
+
+    iterator begin() const {
+        return iterator(first.locked_read_next());
+    }
+
+    iterator end() const {
+        return iterator(last);
+    }
+
+    int size() const {
+        return elements_count;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        for (auto it = begin(); it != end(); it = erase(it));
+    }
+
+    ~intrusive_list() {
+        clear();
+        first->next = nullptr;
+        last->prev = nullptr;
+    }
+
+private:
+    struct hook_chain {
+        node_ptr head;
+        node_ptr tail;
+    };
+
+    static T& value_of(const node_ptr& node) {
+        return *static_cast<T*>(node->owner);
+    }
+
+    node_ptr insert(const node_ptr& pos, T& object) {
+        hook_type& hook = object.*Hook;
+        if (hook.in_use_flag.exchange(true, std::memory_order_acquire)) {
+            throw std::invalid_argument("intrusive_list: the object's hook is in use");
+        }
+        hook.owner = &object;
+        hook.list = this;
+        hook.is_deleted = false;
+        node_ptr node(&hook);
+        hook_chain chain{node, node};
+        link_protocol::link(pos, chain, [this] {
+            ++elements_count;
+        }, contention);
+        return node;
+    }
+
+    std::optional<node_ptr> try_erase_node(const node_ptr& node) {
+        return link_protocol::try_unlink(node, [this] {
+            --elements_count;
+        }, contention);
+    }
+
+    node_ptr first;
+    node_ptr last;
+    contention_policy contention;
+    typename policy_type::template atomic<int> elements_count = 0;
+};
+
+} // polyndrom
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "contention_policy.hpp"
+
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+namespace polyndrom::detail {
+
+// Linking and unlinking of list nodes, shared by acid_list and intrusive_list. NodePtr is a
+// counted pointer to a node with prev and next links of type NodePtr, a shared mutex and an
+// is_deleted flag, with locked_read_next(), locked_read_prev() and locked_read_nodes().
+// Unlinked nodes keep their links, so iterators standing on them can move on. Locks are
+// taken left to right, except by the try_lock fast path. Attempts that find the nodes changed
+// after locking them drop the locks and back off as the list's contention_policy says.
+template<class NodePtr>
+struct link_protocol {
+    using mutex_type = std::remove_cvref_t<decltype(std::declval<NodePtr>()->mutex)>;
+    using read_lock = std::shared_lock<mutex_type>;
+    using write_lock = std::unique_lock<mutex_type>;
+
+    // Links the chain [chain.head, chain.tail], whose nodes are already linked to each
+    // other, before node, or before its first live successor if node is erased. linked()
+    // runs while the locks are still held.
+    template<class Chain, class Linked>
+    static void link(const NodePtr& node, Chain& chain, Linked linked, const contention_policy& contention) {
+        if (!try_link_uncontended(node, chain, linked)) {
+            link_contended(node, chain, linked, contention);
+        }
+    }
+
+    template<class Chain, class Linked>
+    static void link_contended(NodePtr node, Chain& chain, Linked& linked, const contention_policy& contention) {
+        for (backoff wait(contention);; wait()) {
+            while (node->is_deleted) {
+                node = node.locked_read_next();
+            }
+
+            NodePtr prev = node.locked_read_prev();
+
+            write_lock prev_lock(prev->mutex);
+            write_lock current_lock(node->mutex);
+
+            if (node->is_deleted || node->prev != prev) {
+                continue;
+            }
+
+            link_before(node, chain);
+            linked();
+            return;
+        }
+    }
+
+    // Fast path for the single-writer case: with node's write lock held, node->prev can neither
+    // change nor be erased, so it can be linked without the read-lock + refcount round trip of
+    // locked_read_prev() and without revalidation. Locks are taken right-to-left, hence try_lock.
+    template<class Chain, class Linked>
+    static bool try_link_uncontended(const NodePtr& node, Chain& chain, Linked& linked) {
+        write_lock current_lock(node->mutex, std::try_to_lock);
+        if (!current_lock.owns_lock() || node->is_deleted) {
+            return false;
+        }
+        write_lock prev_lock(node->prev->mutex, std::try_to_lock);
+        if (!prev_lock.owns_lock()) {
+            return false;
+        }
+        link_before(node, chain);
+        linked();
+        return true;
+    }
+
+    // Links the chain between prev and next if they are still live neighbours and fits()
+    // holds, calling fits() and then linked() with both write-locked. Returns false without
+    // linking otherwise, leaving the retry to the caller.
+    template<class Chain, class Fits, class Linked>
+    static bool try_link_between(const NodePtr& prev, const NodePtr& next, Chain& chain, Fits fits, Linked linked) {
+        write_lock prev_lock(prev->mutex);
+        write_lock next_lock(next->mutex);
+        if (prev->is_deleted || next->is_deleted || next->prev != prev || !fits()) {
+            return false;
+        }
+        link_before(next, chain);
+        linked();
+        return true;
+    }
+
+    // Requires write locks on node and node->prev. The references prev and node held on each
+    // other are handed over to the chain ends instead of being copied and dropped.
+    template<class Chain>
+    static void link_before(const NodePtr& node, Chain& chain) {
+        chain.tail->next = std::move(node->prev->next);
+        chain.head->prev = std::move(node->prev);
+        chain.head->prev->next = std::move(chain.head);
+        node->prev = std::move(chain.tail);
+    }
+
+    // Moves node before pos, or before its first live successor if pos is erased. The node
+    // stays live throughout, so iterators on it follow it to its new place. Returns false if
+    // node is erased. The window around node is locked left to right, but the one around
+    // pos may be on either side of it and is only try-locked; on failure all locks are
+    // dropped and the move is retried.
+    static bool relink(const NodePtr& node, NodePtr pos, const contention_policy& contention) {
+        for (backoff wait(contention);; wait()) {
+            while (pos->is_deleted) {
+                pos = pos.locked_read_next();
+            }
+            if (pos == node) {
+                return !node->is_deleted;
+            }
+            NodePtr pos_prev = pos.locked_read_prev();
+            auto [prev, next] = node.locked_read_nodes();
+
+            write_lock prev_lock(prev->mutex);
+            write_lock current_lock(node->mutex);
+            write_lock next_lock(next->mutex);
+
+            if (node->is_deleted) {
+                return false;
+            }
+            if (node->prev != prev || node->next != next) {
+                continue;
+            }
+
+            auto is_locked = [&](const NodePtr& other) {
+                return other == prev || other == node || other == next;
+            };
+            write_lock pos_prev_lock(pos_prev->mutex, std::defer_lock);
+            write_lock pos_lock(pos->mutex, std::defer_lock);
+            if ((!is_locked(pos_prev) && !pos_prev_lock.try_lock()) || (!is_locked(pos) && !pos_lock.try_lock())) {
+                continue;
+            }
+            if (pos->is_deleted || pos->prev != pos_prev) {
+                continue;
+            }
+            if (pos_prev == node) {
+                return true;
+            }
+
+            // As in link_before, references are handed over where a link moves.
+            next->prev = std::move(node->prev);
+            prev->next = std::move(node->next);
+            node->prev = std::move(pos->prev);
+            node->next = std::move(pos_prev->next);
+            pos_prev->next = node;
+            pos->prev = node;
+            return true;
+        }
+    }
+
+    // Links the erased node back in after prev, or after its nearest live predecessor if prev
+    // is erased too, and marks it live again. revived() runs while the locks are still held.
+    // Returns false if node isn't erased. Iterators standing on node may be walking from
+    // it, so it is write-locked as well, between its new neighbours.
+    template<class Revived>
+    static bool try_revive(const NodePtr& node, NodePtr prev, Revived revived, const contention_policy& contention) {
+        for (backoff wait(contention);; wait()) {
+            while (prev->is_deleted) {
+                prev = prev.locked_read_prev();
+            }
+            NodePtr next = prev.locked_read_next();
+
+            write_lock prev_lock(prev->mutex);
+            write_lock current_lock(node->mutex);
+            write_lock next_lock(next->mutex);
+
+            if (!node->is_deleted) {
+                return false;
+            }
+            if (prev->is_deleted || prev->next != next) {
+                continue;
+            }
+
+            node->prev = prev;
+            node->next = std::move(prev->next);
+            prev->next = node;
+            next->prev = node;
+            node->is_deleted = false;
+            revived();
+            return true;
+        }
+    }
+
+    // Marks node deleted and unlinks it, calling unlinked() while the locks are still held.
+    // Returns the successor of the node, or nothing if it was already erased.
+    template<class Unlinked>
+    static std::optional<NodePtr> try_unlink(const NodePtr& node, Unlinked unlinked, const contention_policy& contention) {
+        for (backoff wait(contention); !node->is_deleted; wait()) {
+            auto [prev, next] = node.locked_read_nodes();
+
+            write_lock prev_lock(prev->mutex);
+            read_lock current_lock(node->mutex);
+            write_lock next_lock(next->mutex);
+
+            if (node->is_deleted) {
+                return std::nullopt;
+            }
+
+            if (node->prev != prev || node->next != next) {
+                continue;
+            }
+
+            node->is_deleted = true;
+            next->prev = prev;
+            prev->next = next;
+            unlinked();
+            return next;
+        }
+        return std::nullopt;
+    }
+};
+
+} // polyndrom::detail
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "fwd.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+namespace polyndrom {
+
+namespace detail {
+
+struct list_waiter {
+    // Runs in the notifying thread; the waiter is resumed only if it returns true.
+    bool (*try_complete)(list_waiter*) = nullptr;
+    std::coroutine_handle<> handle;
+    list_waiter* next = nullptr;
+};
+
+// Treiber stack of suspended coroutines. Waiters are only ever taken all at once, so there
+// is no single-element pop and therefore no ABA problem.
+class waiter_stack {
+public:
+    void push(list_waiter* waiter) {
+        list_waiter* current = head.load();
+        do {
+            waiter->next = current;
+        } while (!head.compare_exchange_weak(current, waiter));
+    }
+
+    list_waiter* take_all() {
+        return head.exchange(nullptr);
+    }
+
+    bool empty() const {
+        return head.load() == nullptr;
+    }
+
+private:
+    std::atomic<list_waiter*> head = nullptr;
+};
+
+} // detail
+
+// Awaiters are resumed inline by the thread whose insert made them ready, after that
+// insert has released its locks. Nothing is signalled when no coroutine is waiting.
+
+template<class List>
+class nonempty_awaiter : private detail::list_waiter {
+public:
+    explicit nonempty_awaiter(List& list) : list(list) {
+        try_complete = [](detail::list_waiter* waiter) {
+            return static_cast<nonempty_awaiter*>(waiter)->list.size() > 0;
+        };
+    }
+
+    bool await_ready() const {
+        return list.size() > 0;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        handle = awaiting;
+        list.suspend_until_nonempty(this);
+    }
+
+    void await_resume() const {
+    }
+
+private:
+    List& list;
+};
+
+template<class List>
+class pop_front_awaiter : private detail::list_waiter {
+public:
+    using value_type = typename List::value_type;
+
+    explicit pop_front_awaiter(List& list) : list(list) {
+        try_complete = [](detail::list_waiter* waiter) {
+            auto* self = static_cast<pop_front_awaiter*>(waiter);
+            self->value = self->list.try_pop_front();
+            return self->value.has_value();
+        };
+    }
+
+    bool await_ready() {
+        value = list.try_pop_front();
+        return value.has_value();
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        handle = awaiting;
+        list.suspend_until_nonempty(this);
+    }
+
+    value_type await_resume() {
+        return std::move(*value);
+    }
+
+private:
+    List& list;
+    std::optional<value_type> value;
+};
+
+template<class List>
+class insert_awaiter : private detail::list_waiter {
+public:
+    explicit insert_awaiter(List& list) : list(list) {
+        try_complete = [](detail::list_waiter*) {
+            return true;
+        };
+    }
+
+    bool await_ready() const {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        handle = awaiting;
+        list.suspend_until_insert(this);
+    }
+
+    void await_resume() const {
+    }
+
+private:
+    List& list;
+};
+
+} // polyndrom
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace polyndrom {
+
+enum class overflow_policy {
+    // Producers wait until erasures free enough room.
+    block,
+    // The oldest elements are erased to make room.
+    drop_oldest
+};
+
+// Upper bound on the number of elements of an acid_list. A byte budget is converted into
+// an element limit using the size of a list node, so memory owned by the values themselves
+// is not accounted for. Zero means no limit; when both are given the tighter one applies.
+struct list_capacity {
+    size_t max_elements = 0;
+    size_t max_bytes = 0;
+    overflow_policy on_overflow = overflow_policy::block;
+
+    static list_capacity elements(size_t count, overflow_policy on_overflow = overflow_policy::block) {
+        return {count, 0, on_overflow};
+    }
+
+    static list_capacity bytes(size_t count, overflow_policy on_overflow = overflow_policy::block) {
+        return {0, count, on_overflow};
+    }
+
+    size_t element_limit(size_t node_size) const {
+        size_t limit = max_elements;
+        if (max_bytes != 0) {
+            size_t byte_limit = std::max<size_t>(max_bytes / node_size, 1);
+            limit = limit == 0 ? byte_limit : std::min(limit, byte_limit);
+        }
+        return limit;
+    }
+};
+
+} // polyndrom
@@ -4,6 +4,7 @@
 #include "list_node.hpp"
 
 #include <iterator>
+#include <utility>
 
 namespace polyndrom {
 
@@ -13,10 +14,13 @@ private:
     using list_type = List;
 
     friend list_type;
+    friend borrowed_iterator<list_type>;
+    friend borrow_scope<list_type>;
+    friend weak_iterator<list_type>;
 
     using write_lock = typename list_type::write_lock;
     using read_lock = typename list_type::read_lock;
-    using node_ptr = detail::consistent_node_ptr<List>;
+    using node_ptr = typename list_type::node_ptr;
 
 public:
     using iterator_category = std::bidirectional_iterator_tag;
@@ -30,6 +34,8 @@ public:
     list_iterator(const list_iterator& other) : node(other.node) {
     }
 
+    list_iterator(list_iterator&& other) noexcept = default;
+
     list_iterator& operator=(const list_iterator& other) {
         if (node == other.node) {
             return *this;
@@ -38,14 +44,16 @@ public:
         return *this;
     }
 
+    list_iterator& operator=(list_iterator&& other) noexcept = default;
+
     value_type& operator*() {
         read_lock lock(node->mutex);
-        return node->value;
+        return list_type::value_of(node);
     }
 
     value_type* operator->() {
         read_lock lock(node->mutex);
-        return &(node->value);
+        return &list_type::value_of(node);
     }
 
     list_iterator& operator++() {
@@ -87,7 +95,7 @@ public:
     ~list_iterator() = default;
 
 private:
-    explicit list_iterator(node_ptr other_node) : node(other_node) {
+    explicit list_iterator(node_ptr other_node) : node(std::move(other_node)) {
     }
 
 private:
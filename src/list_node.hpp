@@ -1,44 +1,99 @@
 #pragma once
 
 #include "fwd.hpp"
+#include "link_protocol.hpp"
+#include "numa_policy.hpp"
+#include "type_stable_allocator.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <atomic>
+#include <type_traits>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <shared_mutex>
 #include <stack>
+#include <vector>
 
 namespace polyndrom::detail {
 
+// Values that std::atomic_ref can update without a lock get its alignment, so that element
+// updates can bypass the node mutex.
+template<class T>
+constexpr bool is_lock_free_value() {
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+        return std::atomic_ref<T>::is_always_lock_free;
+    } else {
+        return false;
+    }
+}
+
+template<class T>
+constexpr size_t value_alignment() {
+    if constexpr (is_lock_free_value<T>()) {
+        return std::max(alignof(T), std::atomic_ref<T>::required_alignment);
+    } else {
+        return alignof(T);
+    }
+}
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void) address;
+#endif
+}
+
 template<class List>
 class consistent_node_ptr {
 public:
     using list_type = List;
 
     friend list_iterator<list_type>;
+    friend borrowed_iterator<list_type>;
+    friend borrow_scope<list_type>;
+    friend weak_iterator<list_type>;
 
     using write_lock = typename list_type::write_lock;
     using read_lock = typename list_type::read_lock;
     using value_type = typename list_type::value_type;
+    using allocator_type = typename list_type::allocator_type;
 
     class consistent_node {
     private:
         friend list_type;
         friend list_iterator<list_type>;
+        friend borrowed_iterator<list_type>;
+        friend borrow_scope<list_type>;
         friend consistent_node_ptr<list_type>;
+        friend link_protocol<consistent_node_ptr<list_type>>;
+        friend work_partition<list_type>;
 
         using value_type = typename list_type::value_type;
+        using policy_type = typename list_type::policy_type;
 
-        consistent_node() = default;
-
+        // The value is constructed with the allocator if it is allocator-aware itself, as
+        // in standard containers, so e.g. pmr strings in a pmr list share its resource.
         template<typename U>
-        explicit consistent_node(U&& value) : value(std::forward<U>(value)) {}
+        consistent_node(const allocator_type& allocator, U&& value)
+            : value(std::make_obj_using_allocator<value_type>(allocator, std::forward<U>(value))), allocator(allocator) {
+        }
 
         consistent_node_ptr<list_type> prev = nullptr;
         consistent_node_ptr<list_type> next = nullptr;
-        value_type value;
-        std::atomic_size_t ref_count = 0;
-        std::atomic_bool is_deleted = false;
-        std::shared_mutex mutex;
+        alignas(value_alignment<value_type>()) value_type value;
+        typename policy_type::template atomic<size_t> ref_count = 0;
+        typename policy_type::template atomic<bool> is_deleted = false;
+        bool is_pooled = false;
+        // Pass of the work_partition that claimed the node last; fits in the padding.
+        typename policy_type::template atomic<uint32_t> claim_mark = 0;
+        typename policy_type::mutex_type mutex;
+        // Nodes are disposed of by whoever drops the last reference, possibly after the list
+        // is gone, so each keeps its allocator; stateless ones take no room.
+        [[no_unique_address]] allocator_type allocator;
     };
 
     consistent_node_ptr() = default;
@@ -47,12 +102,38 @@ public:
         acquire(other.owned_node);
     }
 
-    explicit consistent_node_ptr(const value_type& value) {
-        acquire(new consistent_node(value));
+    consistent_node_ptr(consistent_node_ptr&& other) noexcept : owned_node(std::exchange(other.owned_node, nullptr)) {
     }
 
-    explicit consistent_node_ptr(value_type&& value) {
-        acquire(new consistent_node(std::move(value)));
+    // NUMA placement only applies to lists with the default allocator; nodes of lists
+    // with other allocators come from the allocator whatever the placement.
+    template<typename U>
+    consistent_node_ptr(const numa_policy& policy, const allocator_type& allocator, U&& value) {
+        if constexpr (std::is_same_v<allocator_type, std::allocator<value_type>> &&
+                      alignof(consistent_node) <= alignof(std::max_align_t)) {
+            if (policy.placement != numa_placement::system_default) {
+                void* memory = numa_pool_for<sizeof(consistent_node)>(policy).allocate();
+                consistent_node* node;
+                try {
+                    node = new (memory) consistent_node(allocator, std::forward<U>(value));
+                } catch (...) {
+                    numa_node_pool::deallocate(memory);
+                    throw;
+                }
+                node->is_pooled = true;
+                acquire(node);
+                return;
+            }
+        }
+        node_allocator node_alloc(allocator);
+        consistent_node* node = node_traits::allocate(node_alloc, 1);
+        try {
+            new (node) consistent_node(allocator, std::forward<U>(value));
+        } catch (...) {
+            node_traits::deallocate(node_alloc, node, 1);
+            throw;
+        }
+        acquire(node);
     }
 
     consistent_node_ptr& operator=(const consistent_node_ptr& other) {
@@ -65,6 +146,15 @@ public:
         return *this;
     }
 
+    consistent_node_ptr& operator=(consistent_node_ptr&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        owned_node = std::exchange(other.owned_node, nullptr);
+        return *this;
+    }
+
     consistent_node_ptr(std::nullptr_t) {
     }
 
@@ -77,6 +167,10 @@ public:
         return owned_node;
     }
 
+    consistent_node* get() const {
+        return owned_node;
+    }
+
     bool operator==(const consistent_node_ptr& rhs) const {
         return owned_node == rhs.owned_node;
     }
@@ -104,6 +198,41 @@ public:
         release();
     }
 
+    // Forgets the node without dropping the reference, so it is never disposed of. For
+    // nodes whose memory is released wholesale by their allocator.
+    void abandon() noexcept {
+        owned_node = nullptr;
+    }
+
+    // Copy of a pointer to a node that isn't linked into a list yet, so no other thread can
+    // count references to it and a plain store does instead of an atomic increment. Slots
+    // of a type_stable_allocator may be locked by weak_iterators to a node freed from them,
+    // so those nodes are always counted atomically.
+    consistent_node_ptr share_unpublished() const {
+        if constexpr (detail::is_type_stable_allocator<allocator_type>::value) {
+            return *this;
+        } else {
+            consistent_node_ptr copy;
+            copy.owned_node = owned_node;
+            owned_node->ref_count.store(owned_node->ref_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return copy;
+        }
+    }
+
+    // Nodes erased from any list of this type that haven't been freed yet. The list counts a
+    // node when it marks it deleted, disposal or linking it back uncounts it.
+    static size_t unreclaimed_count() {
+        return unreclaimed.load(std::memory_order_relaxed);
+    }
+
+    static void count_erased(size_t count) {
+        unreclaimed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    static void uncount_erased(size_t count) {
+        unreclaimed.fetch_sub(count, std::memory_order_relaxed);
+    }
+
 private:
     void acquire(consistent_node* node) {
         owned_node = node;
@@ -112,33 +241,117 @@ private:
         }
     }
 
+    // Takes a reference only if the node is still referenced by someone else. A node whose
+    // count already dropped to zero may only be reachable through a borrowed_iterator and
+    // must not be brought back, as it is already queued for destruction.
+    bool try_acquire(consistent_node* node) {
+        size_t count = node->ref_count.load();
+        while (count != 0) {
+            if (node->ref_count.compare_exchange_weak(count, count + 1)) {
+                owned_node = node;
+                return true;
+            }
+        }
+        return false;
+    }
+
     void release() {
         if (owned_node != nullptr) {
             if (owned_node->ref_count-- == 1) {
-                // std::stack<consistent_node*> nodes_stack;
-                nodes_stack.push(owned_node);
-                while (!nodes_stack.empty()) {
-                    consistent_node* node = nodes_stack.top();
-                    nodes_stack.pop();
-                    consistent_node* prev = node->prev.owned_node;
-                    consistent_node* next = node->next.owned_node;
-                    if (prev != nullptr && prev->ref_count-- == 1) {
-                        nodes_stack.push(prev);
-                    }
-                    if (next != nullptr && next->ref_count-- == 1) {
-                        nodes_stack.push(next);
-                    }
-                    node->prev.owned_node = nullptr;
-                    node->next.owned_node = nullptr;
-                    delete node;
-                }
+                destroy(owned_node);
             }
             owned_node = nullptr;
         }
     }
 
+    static void destroy(consistent_node* root) {
+        if (retire_if_borrowed(root)) {
+            return;
+        }
+        nodes_stack.push(root);
+        while (!nodes_stack.empty()) {
+            consistent_node* node = nodes_stack.top();
+            nodes_stack.pop();
+            consistent_node* prev = node->prev.owned_node;
+            consistent_node* next = node->next.owned_node;
+            if (prev != nullptr && prev->ref_count-- == 1 && !retire_if_borrowed(prev)) {
+                nodes_stack.push(prev);
+            }
+            if (next != nullptr && next->ref_count-- == 1 && !retire_if_borrowed(next)) {
+                nodes_stack.push(next);
+            }
+            node->prev.owned_node = nullptr;
+            node->next.owned_node = nullptr;
+            dispose(node);
+        }
+    }
+
+    static void dispose(consistent_node* node) {
+        if (node->is_deleted) {
+            unreclaimed.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (node->is_pooled) {
+            node->~consistent_node();
+            numa_node_pool::deallocate(node);
+        } else {
+            node_allocator allocator(node->allocator);
+            node->~consistent_node();
+            node_traits::deallocate(allocator, node, 1);
+        }
+    }
+
+    // While any borrow_scope is open, unreferenced nodes are parked with their links intact
+    // instead of being deleted, so borrowed iterators can keep walking through them.
+    struct borrow_domain {
+        std::mutex mutex;
+        std::atomic_size_t borrowers = 0;
+        std::vector<consistent_node*> retired;
+    };
+
+    static borrow_domain& domain() {
+        static borrow_domain instance;
+        return instance;
+    }
+
+    static bool retire_if_borrowed(consistent_node* node) {
+        borrow_domain& borrows = domain();
+        if (borrows.borrowers == 0) {
+            return false;
+        }
+        std::lock_guard lock(borrows.mutex);
+        if (borrows.borrowers == 0) {
+            return false;
+        }
+        borrows.retired.push_back(node);
+        return true;
+    }
+
+    static void enter_borrow() {
+        borrow_domain& borrows = domain();
+        std::lock_guard lock(borrows.mutex);
+        ++borrows.borrowers;
+    }
+
+    static void exit_borrow() {
+        borrow_domain& borrows = domain();
+        std::vector<consistent_node*> retired;
+        {
+            std::lock_guard lock(borrows.mutex);
+            if (--borrows.borrowers == 0) {
+                retired.swap(borrows.retired);
+            }
+        }
+        for (consistent_node* node : retired) {
+            destroy(node);
+        }
+    }
+
 private:
+    using node_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<consistent_node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
     static thread_local std::stack<consistent_node*> nodes_stack;
+    static inline std::atomic_size_t unreclaimed = 0;
     consistent_node* owned_node = nullptr;
 };
 
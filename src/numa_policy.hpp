@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef ACID_LIST_HAS_LIBNUMA
+#include <numa.h>
+#include <sched.h>
+#endif
+
+namespace polyndrom {
+
+enum class numa_placement {
+    system_default,
+    bind,
+    interleave,
+    local
+};
+
+inline int numa_nodes_count() {
+#ifdef ACID_LIST_HAS_LIBNUMA
+    static const int count = numa_available() < 0 ? 1 : numa_max_node() + 1;
+    return count;
+#else
+    return 1;
+#endif
+}
+
+// Node ids need not be dense: numa_nodes_count() is one past the highest id, and an id
+// below it may still name no node.
+inline bool numa_node_exists(int node) {
+    if (node < 0 || node >= numa_nodes_count()) {
+        return false;
+    }
+#ifdef ACID_LIST_HAS_LIBNUMA
+    if (numa_nodes_count() > 1) {
+        return numa_bitmask_isbitset(numa_nodes_ptr, static_cast<unsigned>(node)) != 0;
+    }
+#endif
+    return true;
+}
+
+inline int numa_current_node() {
+#ifdef ACID_LIST_HAS_LIBNUMA
+    if (numa_nodes_count() > 1) {
+        int cpu = sched_getcpu();
+        int node = cpu < 0 ? 0 : numa_node_of_cpu(cpu);
+        return node < 0 ? 0 : node;
+    }
+#endif
+    return 0;
+}
+
+// Where acid_list nodes are allocated. system_default leaves placement to the global heap
+// (first touch), the other modes carve nodes out of per-NUMA-node pools. Without libnuma
+// the machine is treated as a single node and the pools fall back to the global heap.
+struct numa_policy {
+    numa_placement placement = numa_placement::system_default;
+    int node = 0;
+
+    // Throws std::out_of_range if the machine has no such node.
+    static numa_policy bind(int node) {
+        check_node(node);
+        return {numa_placement::bind, node};
+    }
+
+    static numa_policy interleave() {
+        return {numa_placement::interleave, 0};
+    }
+
+    static numa_policy local() {
+        return {numa_placement::local, 0};
+    }
+
+    static void check_node(int node) {
+        if (!numa_node_exists(node)) {
+            throw std::out_of_range("acid_list: no NUMA node " + std::to_string(node));
+        }
+    }
+};
+
+namespace detail {
+
+// Fixed-size block pool whose memory lives on one NUMA node. Every block is prefixed with
+// its owning pool, so a block can be returned from any thread without knowing the list it
+// came from. Chunks are kept for the lifetime of the process.
+//
+// As in type_stable_pool, every thread keeps up to 2 * batch_blocks free blocks of each pool
+// and moves batch_blocks at a time from and to the pool's shared free list, so the pool's
+// mutex is taken once per batch rather than on every allocation and free.
+class numa_node_pool {
+public:
+    numa_node_pool(int node, size_t block_size)
+        : node(node), block_size(header_size + round_up(block_size)), cache_index(next_cache_index()) {
+    }
+
+    numa_node_pool(const numa_node_pool&) = delete;
+    numa_node_pool& operator=(const numa_node_pool&) = delete;
+
+    void* allocate() {
+        free_block* block;
+        if (thread_cache* cache = local_cache()) {
+            if (cache->free_list == nullptr) {
+                refill(*cache);
+            }
+            block = cache->free_list;
+            cache->free_list = block->next;
+            --cache->count;
+        } else {
+            std::lock_guard lock(mutex);
+            if (free_list == nullptr) {
+                grow();
+            }
+            block = free_list;
+            free_list = block->next;
+        }
+        auto* header = reinterpret_cast<numa_node_pool**>(block);
+        *header = this;
+        return reinterpret_cast<std::byte*>(block) + header_size;
+    }
+
+    static void deallocate(void* ptr) {
+        std::byte* block = static_cast<std::byte*>(ptr) - header_size;
+        numa_node_pool* owner = *reinterpret_cast<numa_node_pool**>(block);
+        auto* free = reinterpret_cast<free_block*>(block);
+        if (thread_cache* cache = owner->local_cache()) {
+            free->next = cache->free_list;
+            cache->free_list = free;
+            if (++cache->count > 2 * batch_blocks) {
+                owner->drain(*cache, batch_blocks);
+            }
+        } else {
+            std::lock_guard lock(owner->mutex);
+            free->next = owner->free_list;
+            owner->free_list = free;
+        }
+    }
+
+    int numa_node() const {
+        return node;
+    }
+
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    struct thread_cache {
+        numa_node_pool* pool = nullptr;
+        free_block* free_list = nullptr;
+        size_t count = 0;
+    };
+
+    // One cache per pool, indexed by the pool's cache_index. Trivially destructible, so that
+    // blocks freed after the thread's thread_local destructors have run can still see that
+    // the caches are gone and go to the pools directly.
+    struct thread_caches {
+        thread_cache* caches = nullptr;
+        size_t size = 0;
+        bool retired = false;
+    };
+
+    // Hands the free blocks of an exiting thread back to their pools.
+    struct cache_release {
+        thread_caches& local;
+
+        ~cache_release() {
+            for (size_t i = 0; i < local.size; i++) {
+                if (local.caches[i].pool != nullptr) {
+                    local.caches[i].pool->drain(local.caches[i], local.caches[i].count);
+                }
+            }
+            delete[] local.caches;
+            local.caches = nullptr;
+            local.size = 0;
+            local.retired = true;
+        }
+    };
+
+    static constexpr size_t header_size = alignof(std::max_align_t);
+    static constexpr size_t chunk_size = 1 << 20;
+    static constexpr size_t batch_blocks = 64;
+
+    static size_t next_cache_index() {
+        static std::atomic<size_t> pools_count = 0;
+        return pools_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    thread_cache* local_cache() {
+        thread_local thread_caches local;
+        thread_local cache_release release{local};
+        if (local.retired) {
+            return nullptr;
+        }
+        if (cache_index >= local.size) {
+            const size_t size = std::max(cache_index + 1, 2 * local.size);
+            auto* caches = new thread_cache[size];
+            std::copy(local.caches, local.caches + local.size, caches);
+            delete[] local.caches;
+            local.caches = caches;
+            local.size = size;
+        }
+        thread_cache& cache = local.caches[cache_index];
+        cache.pool = this;
+        return &cache;
+    }
+
+    void refill(thread_cache& cache) {
+        std::lock_guard lock(mutex);
+        if (free_list == nullptr) {
+            grow();
+        }
+        for (size_t moved = 0; moved < batch_blocks && free_list != nullptr; moved++) {
+            free_block* free = free_list;
+            free_list = free->next;
+            free->next = cache.free_list;
+            cache.free_list = free;
+            ++cache.count;
+        }
+    }
+
+    void drain(thread_cache& cache, size_t count) {
+        std::lock_guard lock(mutex);
+        for (; count != 0 && cache.free_list != nullptr; count--) {
+            free_block* free = cache.free_list;
+            cache.free_list = free->next;
+            --cache.count;
+            free->next = free_list;
+            free_list = free;
+        }
+    }
+
+    static size_t round_up(size_t size) {
+        return (size + header_size - 1) / header_size * header_size;
+    }
+
+    void grow() {
+        std::byte* chunk = allocate_chunk();
+        for (size_t offset = 0; offset + block_size <= chunk_size; offset += block_size) {
+            auto* block = reinterpret_cast<free_block*>(chunk + offset);
+            block->next = free_list;
+            free_list = block;
+        }
+    }
+
+    std::byte* allocate_chunk() {
+#ifdef ACID_LIST_HAS_LIBNUMA
+        if (numa_nodes_count() > 1) {
+            void* chunk = numa_alloc_onnode(chunk_size, node);
+            if (chunk == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<std::byte*>(chunk);
+        }
+#endif
+        return static_cast<std::byte*>(::operator new(chunk_size));
+    }
+
+private:
+    std::mutex mutex;
+    free_block* free_list = nullptr;
+    const int node;
+    const size_t block_size;
+    const size_t cache_index;
+};
+
+template<size_t BlockSize>
+numa_node_pool& numa_pool_for_node(int node) {
+    static std::vector<numa_node_pool*>* pools = [] {
+        auto* pools = new std::vector<numa_node_pool*>();
+        for (int i = 0; i < numa_nodes_count(); i++) {
+            pools->push_back(numa_node_exists(i) ? new numa_node_pool(i, BlockSize) : nullptr);
+        }
+        return pools;
+    }();
+    // A policy made without bind() may name any node.
+    numa_policy::check_node(node);
+    return *(*pools)[static_cast<size_t>(node)];
+}
+
+template<size_t BlockSize>
+numa_node_pool& numa_pool_for(const numa_policy& policy) {
+    switch (policy.placement) {
+        case numa_placement::bind:
+            return numa_pool_for_node<BlockSize>(policy.node);
+        case numa_placement::interleave: {
+            static thread_local unsigned cursor = 0;
+            int node = static_cast<int>(cursor++ % numa_nodes_count());
+            while (!numa_node_exists(node)) {
+                node = static_cast<int>(cursor++ % numa_nodes_count());
+            }
+            return numa_pool_for_node<BlockSize>(node);
+        }
+        default:
+            return numa_pool_for_node<BlockSize>(numa_current_node());
+    }
+}
+
+} // detail
+
+} // polyndrom
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "acid_list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace polyndrom {
+
+enum class delete_mode {
+    // Take one of the first spray_width elements, picked at random, so that consumers spread
+    // over the front of the list instead of all locking its first node.
+    relaxed,
+    // Take the first element.
+    strict
+};
+
+// Priority queue keeping its entries in an acid_list ordered by priority, the smallest under
+// Compare first and equal priorities in insertion order. Entries are placed with
+// acid_list::insert_sorted, starting from the closest of a few hints, which are iterators to
+// recently inserted entries, rather than from the front.
+//
+// Relaxed delete_min works like a SprayList: a consumer walks a random number of elements,
+// below spray_width, from the front and extracts the element it lands on, trying again if
+// another consumer took it first. The entry taken is thus among the spray_width smallest
+// ones when the walk starts. Strict delete_min pops the front like acid_list::try_pop_front.
+template<class P, class T, class Compare = std::less<P>>
+class concurrent_priority_list {
+public:
+    struct entry {
+        P priority;
+        T value;
+    };
+
+    static constexpr size_t hints_count = 16;
+
+    explicit concurrent_priority_list(delete_mode mode = delete_mode::relaxed, size_t spray_width = default_spray_width(),
+                                      Compare comp = Compare())
+        : mode(mode), spray_width(std::max<size_t>(spray_width, 1)), comp(std::move(comp)) {
+        for (hint& slot : hints) {
+            slot.position = entries.end();
+        }
+    }
+
+    concurrent_priority_list(const concurrent_priority_list&) = delete;
+    concurrent_priority_list& operator=(const concurrent_priority_list&) = delete;
+
+    // One consumer per hardware thread spreads over as many elements.
+    static size_t default_spray_width() {
+        return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 64);
+    }
+
+    void insert(P priority, T value) {
+        iterator end = entries.end();
+        iterator start = end;
+        std::optional<P> start_priority;
+        for (hint& slot : hints) {
+            std::lock_guard lock(slot.mutex);
+            if (slot.position == end || comp(priority, slot.priority)) {
+                continue;
+            }
+            if (!start_priority || comp(*start_priority, slot.priority)) {
+                start = slot.position;
+                start_priority = slot.priority;
+            }
+        }
+        iterator inserted = entries.insert_sorted(start, entry{priority, std::move(value)}, entry_order{comp});
+
+        hint& slot = hints[next_hint.fetch_add(1, std::memory_order_relaxed) % hints_count];
+        std::lock_guard lock(slot.mutex);
+        slot.position = std::move(inserted);
+        slot.priority = std::move(priority);
+    }
+
+    // Removes an entry with the smallest priority, or one close to it in relaxed mode.
+    // Returns nothing if the list is empty.
+    std::optional<entry> delete_min() {
+        return delete_min(mode);
+    }
+
+    std::optional<entry> delete_min(delete_mode with_mode) {
+        if (with_mode == delete_mode::strict) {
+            return entries.try_pop_front();
+        }
+        while (true) {
+            iterator end = entries.end();
+            iterator target = entries.begin();
+            if (target == end) {
+                return std::nullopt;
+            }
+            for (size_t steps = detail::backoff_jitter() % spray_width; steps != 0; --steps) {
+                iterator next = std::next(target);
+                if (next == end) {
+                    break;
+                }
+                target = std::move(next);
+            }
+            if (std::optional<entry> taken = entries.try_extract(target)) {
+                return taken;
+            }
+        }
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(entries.size());
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    delete_mode deletion() const {
+        return mode;
+    }
+
+private:
+    using list_type = acid_list<entry>;
+    using iterator = typename list_type::iterator;
+
+    struct entry_order {
+        const Compare& comp;
+
+        bool operator()(const entry& lhs, const entry& rhs) const {
+            return comp(lhs.priority, rhs.priority);
+        }
+    };
+
+    // The priority is kept apart from the entry, whose fields are moved out on extraction.
+    struct alignas(64) hint {
+        std::mutex mutex;
+        iterator position;
+        P priority{};
+    };
+
+    const delete_mode mode;
+    const size_t spray_width;
+    Compare comp;
+    list_type entries;
+    std::array<hint, hints_count> hints;
+    std::atomic_size_t next_hint = 0;
+};
+
+} // polyndrom
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace polyndrom::detail {
+
+struct snapshot_header {
+    static constexpr char expected_magic[8] = {'A', 'C', 'I', 'D', 'L', 'S', 'T', '\0'};
+    static constexpr uint32_t current_version = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t value_size;
+    uint64_t count;
+
+    static snapshot_header make(size_t value_size, size_t count) {
+        snapshot_header header{};
+        std::memcpy(header.magic, expected_magic, sizeof(magic));
+        header.version = current_version;
+        header.value_size = static_cast<uint32_t>(value_size);
+        header.count = count;
+        return header;
+    }
+
+    // Checks the header itself. max_count bounds count for readers that don't know the
+    // payload's size up front.
+    void validate(size_t expected_value_size, uint64_t max_count) const {
+        if (std::memcmp(magic, expected_magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("acid_list snapshot: bad magic");
+        }
+        if (version != current_version) {
+            throw std::runtime_error("acid_list snapshot: unsupported version " + std::to_string(version));
+        }
+        if (value_size != expected_value_size) {
+            throw std::runtime_error("acid_list snapshot: value size mismatch");
+        }
+        if (count > max_count) {
+            throw std::runtime_error("acid_list snapshot: too many values (" + std::to_string(count) + ")");
+        }
+    }
+
+    // Requires a validated header.
+    void validate_payload(size_t payload_size) const {
+        if (payload_size / value_size < count) {
+            throw std::runtime_error("acid_list snapshot: truncated payload");
+        }
+    }
+};
+
+inline void write_all(int fd, const std::byte* data, size_t size) {
+    while (size != 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "acid_list snapshot: write");
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+// Read-only private mapping of a whole file.
+class mapped_file {
+public:
+    explicit mapped_file(int fd) {
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            throw std::system_error(errno, std::generic_category(), "acid_list snapshot: fstat");
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size == 0) {
+            return;
+        }
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "acid_list snapshot: mmap");
+        }
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const std::byte*>(mapping);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+        if (data != nullptr) {
+            ::munmap(const_cast<std::byte*>(data), size);
+        }
+    }
+
+    const std::byte* data = nullptr;
+    size_t size = 0;
+};
+
+class file_descriptor {
+public:
+    explicit file_descriptor(const std::string& path) : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "acid_list snapshot: open " + path);
+        }
+    }
+
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    ~file_descriptor() {
+        ::close(fd);
+    }
+
+    const int fd;
+};
+
+} // polyndrom::detail
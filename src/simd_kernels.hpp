@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define ACID_LIST_HAS_AVX2_KERNELS
+#define ACID_LIST_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Reductions over contiguous batches of arithmetic values. AVX2 kernels are compiled for
+// 32- and 64-bit integers and floating point types and picked at run time when the CPU has
+// AVX2; everything else goes through the plain loops, which the compiler vectorizes for the
+// baseline instruction set where it can. Floating point sums are reassociated by the
+// vector kernels.
+
+namespace polyndrom::detail {
+
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+
+inline bool cpu_has_avx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+template<class T>
+struct avx2_lanes;
+
+template<>
+struct avx2_lanes<int32_t> {
+    using vector = __m256i;
+    static constexpr size_t width = 8;
+
+    ACID_LIST_TARGET_AVX2 static vector load(const int32_t* data) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+    ACID_LIST_TARGET_AVX2 static vector broadcast(int32_t value) {
+        return _mm256_set1_epi32(value);
+    }
+    ACID_LIST_TARGET_AVX2 static unsigned equal_mask(vector lhs, vector rhs) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lhs, rhs)));
+    }
+    ACID_LIST_TARGET_AVX2 static vector min(vector lhs, vector rhs) {
+        return _mm256_min_epi32(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector max(vector lhs, vector rhs) {
+        return _mm256_max_epi32(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector add(vector lhs, vector rhs) {
+        return _mm256_add_epi32(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static void store(int32_t* data, vector value) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value);
+    }
+};
+
+template<>
+struct avx2_lanes<int64_t> {
+    using vector = __m256i;
+    static constexpr size_t width = 4;
+
+    ACID_LIST_TARGET_AVX2 static vector load(const int64_t* data) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+    ACID_LIST_TARGET_AVX2 static vector broadcast(int64_t value) {
+        return _mm256_set1_epi64x(value);
+    }
+    ACID_LIST_TARGET_AVX2 static unsigned equal_mask(vector lhs, vector rhs) {
+        return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lhs, rhs)));
+    }
+    // AVX2 has no 64-bit min/max, so they are a compare and a blend.
+    ACID_LIST_TARGET_AVX2 static vector min(vector lhs, vector rhs) {
+        return _mm256_blendv_epi8(lhs, rhs, _mm256_cmpgt_epi64(lhs, rhs));
+    }
+    ACID_LIST_TARGET_AVX2 static vector max(vector lhs, vector rhs) {
+        return _mm256_blendv_epi8(rhs, lhs, _mm256_cmpgt_epi64(lhs, rhs));
+    }
+    ACID_LIST_TARGET_AVX2 static vector add(vector lhs, vector rhs) {
+        return _mm256_add_epi64(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static void store(int64_t* data, vector value) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value);
+    }
+};
+
+template<>
+struct avx2_lanes<float> {
+    using vector = __m256;
+    static constexpr size_t width = 8;
+
+    ACID_LIST_TARGET_AVX2 static vector load(const float* data) {
+        return _mm256_loadu_ps(data);
+    }
+    ACID_LIST_TARGET_AVX2 static vector broadcast(float value) {
+        return _mm256_set1_ps(value);
+    }
+    ACID_LIST_TARGET_AVX2 static unsigned equal_mask(vector lhs, vector rhs) {
+        return _mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ));
+    }
+    ACID_LIST_TARGET_AVX2 static vector min(vector lhs, vector rhs) {
+        return _mm256_min_ps(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector max(vector lhs, vector rhs) {
+        return _mm256_max_ps(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector add(vector lhs, vector rhs) {
+        return _mm256_add_ps(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static void store(float* data, vector value) {
+        _mm256_storeu_ps(data, value);
+    }
+};
+
+template<>
+struct avx2_lanes<double> {
+    using vector = __m256d;
+    static constexpr size_t width = 4;
+
+    ACID_LIST_TARGET_AVX2 static vector load(const double* data) {
+        return _mm256_loadu_pd(data);
+    }
+    ACID_LIST_TARGET_AVX2 static vector broadcast(double value) {
+        return _mm256_set1_pd(value);
+    }
+    ACID_LIST_TARGET_AVX2 static unsigned equal_mask(vector lhs, vector rhs) {
+        return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ));
+    }
+    ACID_LIST_TARGET_AVX2 static vector min(vector lhs, vector rhs) {
+        return _mm256_min_pd(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector max(vector lhs, vector rhs) {
+        return _mm256_max_pd(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static vector add(vector lhs, vector rhs) {
+        return _mm256_add_pd(lhs, rhs);
+    }
+    ACID_LIST_TARGET_AVX2 static void store(double* data, vector value) {
+        _mm256_storeu_pd(data, value);
+    }
+};
+
+template<class T>
+concept has_avx2_lanes = requires {
+    avx2_lanes<T>::width;
+};
+
+template<class T>
+ACID_LIST_TARGET_AVX2 size_t avx2_count_equal(const T* data, size_t size, T value) {
+    using lanes = avx2_lanes<T>;
+    const auto needle = lanes::broadcast(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + lanes::width <= size; i += lanes::width) {
+        count += std::popcount(lanes::equal_mask(lanes::load(data + i), needle));
+    }
+    for (; i < size; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+template<class T>
+ACID_LIST_TARGET_AVX2 size_t avx2_find_equal(const T* data, size_t size, T value) {
+    using lanes = avx2_lanes<T>;
+    const auto needle = lanes::broadcast(value);
+    size_t i = 0;
+    for (; i + lanes::width <= size; i += lanes::width) {
+        unsigned mask = lanes::equal_mask(lanes::load(data + i), needle);
+        if (mask != 0) {
+            return i + std::countr_zero(mask);
+        }
+    }
+    for (; i < size; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+enum class reduce_op {
+    min,
+    max,
+    sum
+};
+
+template<reduce_op Op, class T>
+T reduce_scalar(T lhs, T rhs) {
+    if constexpr (Op == reduce_op::min) {
+        return std::min(lhs, rhs);
+    } else if constexpr (Op == reduce_op::max) {
+        return std::max(lhs, rhs);
+    } else {
+        return static_cast<T>(lhs + rhs);
+    }
+}
+
+// Folds data lane-wise and then folds the lanes; size must be at least one vector.
+template<reduce_op Op, class T>
+ACID_LIST_TARGET_AVX2 T avx2_reduce(const T* data, size_t size) {
+    using lanes = avx2_lanes<T>;
+    auto accumulator = lanes::load(data);
+    const size_t vectorized = size - size % lanes::width;
+    size_t i = lanes::width;
+    for (; i < vectorized; i += lanes::width) {
+        auto values = lanes::load(data + i);
+        if constexpr (Op == reduce_op::min) {
+            accumulator = lanes::min(accumulator, values);
+        } else if constexpr (Op == reduce_op::max) {
+            accumulator = lanes::max(accumulator, values);
+        } else {
+            accumulator = lanes::add(accumulator, values);
+        }
+    }
+    T values[lanes::width];
+    lanes::store(values, accumulator);
+    T result = values[0];
+    for (size_t lane = 1; lane < lanes::width; lane++) {
+        result = reduce_scalar<Op>(result, values[lane]);
+    }
+    for (; i < size; ++i) {
+        result = reduce_scalar<Op>(result, data[i]);
+    }
+    return result;
+}
+
+#endif
+
+template<class T>
+size_t count_equal(const T* data, size_t size, T value) {
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+    if constexpr (has_avx2_lanes<T>) {
+        if (cpu_has_avx2()) {
+            return avx2_count_equal(data, size, value);
+        }
+    }
+#endif
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+// Index of the first element equal to value, or size if there is none.
+template<class T>
+size_t find_equal(const T* data, size_t size, T value) {
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+    if constexpr (has_avx2_lanes<T>) {
+        if (cpu_has_avx2()) {
+            return avx2_find_equal(data, size, value);
+        }
+    }
+#endif
+    return static_cast<size_t>(std::find(data, data + size, value) - data);
+}
+
+// The reductions below require size > 0.
+
+template<class T>
+T min_value(const T* data, size_t size) {
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+    if constexpr (has_avx2_lanes<T>) {
+        if (cpu_has_avx2() && size >= avx2_lanes<T>::width) {
+            return avx2_reduce<reduce_op::min>(data, size);
+        }
+    }
+#endif
+    return *std::min_element(data, data + size);
+}
+
+template<class T>
+T max_value(const T* data, size_t size) {
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+    if constexpr (has_avx2_lanes<T>) {
+        if (cpu_has_avx2() && size >= avx2_lanes<T>::width) {
+            return avx2_reduce<reduce_op::max>(data, size);
+        }
+    }
+#endif
+    return *std::max_element(data, data + size);
+}
+
+template<class T>
+T sum_values(const T* data, size_t size) {
+#ifdef ACID_LIST_HAS_AVX2_KERNELS
+    if constexpr (has_avx2_lanes<T>) {
+        if (cpu_has_avx2() && size >= avx2_lanes<T>::width) {
+            return avx2_reduce<reduce_op::sum>(data, size);
+        }
+    }
+#endif
+    T sum = 0;
+    for (size_t i = 0; i < size; i++) {
+        sum = static_cast<T>(sum + data[i]);
+    }
+    return sum;
+}
+
+} // polyndrom::detail
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace polyndrom {
+
+template<class... Fields>
+class soa_arena;
+
+// Owning reference to one record of a soa_arena, released when the reference is destroyed.
+// Used as the value type of an acid_list it keeps nodes small: the links stay in the node
+// and the payload lives in the arena's per-field arrays.
+template<class... Fields>
+class soa_record {
+public:
+    using arena_type = soa_arena<Fields...>;
+
+    // Refers to no record; only list sentinels are default-constructed.
+    soa_record() = default;
+
+    soa_record(soa_record&& other) noexcept
+        : owner(std::exchange(other.owner, nullptr)), index(other.index) {
+    }
+
+    soa_record& operator=(soa_record&& other) noexcept {
+        if (this != &other) {
+            reset();
+            owner = std::exchange(other.owner, nullptr);
+            index = other.index;
+        }
+        return *this;
+    }
+
+    soa_record(const soa_record&) = delete;
+    soa_record& operator=(const soa_record&) = delete;
+
+    ~soa_record() {
+        reset();
+    }
+
+    template<size_t I>
+    auto get() const {
+        return arena_type::template load<I>(*owner, index);
+    }
+
+    template<size_t I, class U>
+    void set(U&& value) const {
+        arena_type::template store<I>(*owner, index, std::forward<U>(value));
+    }
+
+    std::tuple<Fields...> load() const {
+        return arena_type::load_record(*owner, index);
+    }
+
+private:
+    friend arena_type;
+
+    using chunk_type = typename arena_type::chunk;
+
+    soa_record(chunk_type* owner, uint32_t index) : owner(owner), index(index) {
+    }
+
+    void reset() {
+        if (owner != nullptr) {
+            arena_type::release(*owner, index);
+            owner = nullptr;
+        }
+    }
+
+    chunk_type* owner = nullptr;
+    uint32_t index = 0;
+};
+
+// Structure-of-arrays storage for records of trivially copyable fields. Records live in
+// fixed-size chunks, one array per field, so a scan over one field reads it contiguously.
+// Chunks are visited in arena order, which is unrelated to the order of any list holding
+// the records, and a record stays visible to scans until its soa_record is destroyed,
+// which for a list element is when the node is reclaimed rather than when it is erased.
+// The arena must outlive every record it handed out.
+template<class... Fields>
+class soa_arena {
+    static_assert(sizeof...(Fields) > 0);
+    static_assert((std::is_trivially_copyable_v<Fields> && ...));
+    static_assert((std::is_default_constructible_v<Fields> && ...));
+
+public:
+    using record_type = soa_record<Fields...>;
+
+    template<size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    static constexpr size_t chunk_capacity = 1024;
+    static constexpr size_t mask_words = chunk_capacity / 64;
+
+    soa_arena() = default;
+
+    soa_arena(const soa_arena&) = delete;
+    soa_arena& operator=(const soa_arena&) = delete;
+
+    record_type make(Fields... values) {
+        auto [owner, index] = allocate_slot();
+        {
+            std::unique_lock lock(owner->mutex);
+            store_fields(*owner, index, std::index_sequence_for<Fields...>{}, values...);
+            owner->live[index / 64] |= uint64_t{1} << (index % 64);
+        }
+        live_count.fetch_add(1, std::memory_order_relaxed);
+        return record_type(owner, index);
+    }
+
+    size_t size() const {
+        return live_count.load(std::memory_order_relaxed);
+    }
+
+    // Calls fn(column, live) for every chunk, where column is the chunk's array of field I
+    // and bit i of live tells whether column[i] belongs to a record. Each chunk is
+    // read-locked while fn runs; records may be added or released between chunks.
+    template<size_t I, class Fn>
+    void for_each_chunk(Fn fn) const {
+        std::shared_lock chunks_lock(chunks_mutex);
+        for (const auto& owner : chunks) {
+            std::shared_lock lock(owner->mutex);
+            fn(std::span<const field_type<I>, chunk_capacity>(std::get<I>(owner->columns)),
+               std::span<const uint64_t, mask_words>(owner->live));
+        }
+    }
+
+    // Number of records whose field I satisfies pred. The predicate is evaluated for every
+    // slot, live or not, so that the inner loop has no branches and can be vectorized.
+    template<size_t I, class Pred>
+    size_t count_if(Pred pred) const {
+        size_t count = 0;
+        for_each_chunk<I>([&count, &pred](auto column, auto live) {
+            for (size_t word = 0; word < mask_words; word++) {
+                uint64_t matches = 0;
+                for (size_t bit = 0; bit < 64; bit++) {
+                    matches |= static_cast<uint64_t>(static_cast<bool>(pred(column[word * 64 + bit]))) << bit;
+                }
+                count += std::popcount(matches & live[word]);
+            }
+        });
+        return count;
+    }
+
+    // Some record whose field I satisfies pred, copied out under the chunk's lock.
+    template<size_t I, class Pred>
+    std::optional<std::tuple<Fields...>> find_if(Pred pred) const {
+        std::shared_lock chunks_lock(chunks_mutex);
+        for (const auto& owner : chunks) {
+            std::shared_lock lock(owner->mutex);
+            const auto& column = std::get<I>(owner->columns);
+            for (size_t word = 0; word < mask_words; word++) {
+                for (uint64_t live = owner->live[word]; live != 0; live &= live - 1) {
+                    size_t index = word * 64 + std::countr_zero(live);
+                    if (pred(column[index])) {
+                        return load_fields(*owner, index, std::index_sequence_for<Fields...>{});
+                    }
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    friend record_type;
+
+    struct chunk {
+        explicit chunk(soa_arena& arena) : arena(arena) {
+        }
+
+        soa_arena& arena;
+        mutable std::shared_mutex mutex;
+        uint64_t live[mask_words] = {};
+        std::tuple<std::array<Fields, chunk_capacity>...> columns;
+    };
+
+    std::pair<chunk*, uint32_t> allocate_slot() {
+        std::lock_guard lock(free_mutex);
+        if (free_slots.empty()) {
+            auto owner = std::make_unique<chunk>(*this);
+            for (size_t i = chunk_capacity; i-- > 0;) {
+                free_slots.emplace_back(owner.get(), static_cast<uint32_t>(i));
+            }
+            std::unique_lock chunks_lock(chunks_mutex);
+            chunks.push_back(std::move(owner));
+        }
+        auto slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    }
+
+    static void release(chunk& owner, uint32_t index) {
+        {
+            std::unique_lock lock(owner.mutex);
+            owner.live[index / 64] &= ~(uint64_t{1} << (index % 64));
+        }
+        soa_arena& arena = owner.arena;
+        arena.live_count.fetch_sub(1, std::memory_order_relaxed);
+        std::lock_guard lock(arena.free_mutex);
+        arena.free_slots.emplace_back(&owner, index);
+    }
+
+    template<size_t I>
+    static field_type<I> load(const chunk& owner, uint32_t index) {
+        std::shared_lock lock(owner.mutex);
+        return std::get<I>(owner.columns)[index];
+    }
+
+    template<size_t I, class U>
+    static void store(chunk& owner, uint32_t index, U&& value) {
+        std::unique_lock lock(owner.mutex);
+        std::get<I>(owner.columns)[index] = std::forward<U>(value);
+    }
+
+    static std::tuple<Fields...> load_record(const chunk& owner, uint32_t index) {
+        std::shared_lock lock(owner.mutex);
+        return load_fields(owner, index, std::index_sequence_for<Fields...>{});
+    }
+
+    template<size_t... Is>
+    static std::tuple<Fields...> load_fields(const chunk& owner, size_t index, std::index_sequence<Is...>) {
+        return std::tuple<Fields...>(std::get<Is>(owner.columns)[index]...);
+    }
+
+    template<size_t... Is>
+    static void store_fields(chunk& owner, size_t index, std::index_sequence<Is...>, const Fields&... values) {
+        ((std::get<Is>(owner.columns)[index] = values), ...);
+    }
+
+    mutable std::shared_mutex chunks_mutex;
+    std::vector<std::unique_ptr<chunk>> chunks;
+    std::mutex free_mutex;
+    std::vector<std::pair<chunk*, uint32_t>> free_slots;
+    std::atomic_size_t live_count = 0;
+};
+
+} // polyndrom
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+#include <utility>
+
+namespace polyndrom {
+
+namespace detail {
+
+struct null_shared_mutex {
+    void lock() {
+    }
+    bool try_lock() {
+        return true;
+    }
+    void unlock() {
+    }
+    void lock_shared() {
+    }
+    bool try_lock_shared() {
+        return true;
+    }
+    void unlock_shared() {
+    }
+};
+
+// Plain value behind the part of the std::atomic interface the list uses.
+template<class T>
+class unsynchronized {
+public:
+    constexpr unsynchronized(T value = T()) noexcept : value(value) {
+    }
+
+    unsynchronized(const unsynchronized&) = delete;
+    unsynchronized& operator=(const unsynchronized&) = delete;
+
+    T load(std::memory_order = std::memory_order_seq_cst) const {
+        return value;
+    }
+
+    void store(T desired, std::memory_order = std::memory_order_seq_cst) {
+        value = desired;
+    }
+
+    operator T() const {
+        return value;
+    }
+
+    T operator=(T desired) {
+        value = desired;
+        return desired;
+    }
+
+    T exchange(T desired, std::memory_order = std::memory_order_seq_cst) {
+        return std::exchange(value, desired);
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, desired);
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order = std::memory_order_seq_cst) {
+        if (value == expected) {
+            value = desired;
+            return true;
+        }
+        expected = value;
+        return false;
+    }
+
+    T fetch_add(T arg, std::memory_order = std::memory_order_seq_cst) {
+        T old = value;
+        value += arg;
+        return old;
+    }
+
+    T fetch_sub(T arg, std::memory_order = std::memory_order_seq_cst) {
+        T old = value;
+        value -= arg;
+        return old;
+    }
+
+    T operator++() {
+        return ++value;
+    }
+
+    T operator++(int) {
+        return value++;
+    }
+
+    T operator--() {
+        return --value;
+    }
+
+    T operator--(int) {
+        return value--;
+    }
+
+    T operator+=(T arg) {
+        return value += arg;
+    }
+
+    T operator-=(T arg) {
+        return value -= arg;
+    }
+
+    void wait(T, std::memory_order = std::memory_order_seq_cst) const {
+    }
+
+    void notify_all() {
+    }
+
+private:
+    T value;
+};
+
+} // detail
+
+// Synchronization used by an acid_list for its nodes and counters. State shared by all
+// lists of a type, like the borrow domain and the NUMA pools, is synchronized either way.
+struct multi_thread_policy {
+    static constexpr bool is_concurrent = true;
+
+    using mutex_type = std::shared_mutex;
+
+    template<class U>
+    using atomic = std::atomic<U>;
+};
+
+// For lists that are used by one thread at a time: node locks are no-ops and reference
+// counts and sizes are plain integers. Iterators keep the same stability guarantees.
+struct single_thread_policy {
+    static constexpr bool is_concurrent = false;
+
+    using mutex_type = detail::null_shared_mutex;
+
+    template<class U>
+    using atomic = detail::unsynchronized<U>;
+};
+
+} // polyndrom
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace polyndrom {
+
+namespace detail {
+
+// Pool of single objects of type T whose memory is never given back: a freed slot only
+// ever holds another T. Every slot carries a generation that is bumped when its object is
+// freed, so a pointer and the generation read while the object was alive tell whether it is
+// still the same object, without keeping it alive.
+//
+// Every thread keeps up to 2 * batch_slots free slots of its own and moves batch_slots at a
+// time from and to the shared free list, so the pool's mutex is taken once per batch rather
+// than on every allocation and free.
+template<class T>
+class type_stable_pool {
+public:
+    static T* allocate() {
+        thread_cache& cache = local_cache();
+        if (cache.free_list == nullptr) {
+            instance().refill(cache);
+        }
+        slot* free = cache.free_list;
+        cache.free_list = free->next_free;
+        --cache.count;
+        return reinterpret_cast<T*>(free->storage);
+    }
+
+    static void deallocate(T* object) {
+        slot* freed = slot_of(object);
+        freed->generation.fetch_add(1, std::memory_order_release);
+        thread_cache& cache = local_cache();
+        freed->next_free = cache.free_list;
+        cache.free_list = freed;
+        if (++cache.count > 2 * batch_slots || cache.retired) {
+            instance().drain(cache, cache.retired ? cache.count : batch_slots);
+        }
+    }
+
+    static uint64_t generation(const T* object) {
+        return slot_of(object)->generation.load(std::memory_order_acquire);
+    }
+
+private:
+    // The object comes first, so that its address is the slot's. Free slots are chained
+    // outside of it, leaving the bytes of a freed object as they were.
+    struct slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<uint64_t> generation = 0;
+        slot* next_free = nullptr;
+    };
+
+    // Trivially destructible, so that it can still be used, uncached, by objects freed
+    // after the thread's thread_local destructors have run.
+    struct thread_cache {
+        slot* free_list = nullptr;
+        size_t count = 0;
+        bool retired = false;
+    };
+
+    // Hands the free slots of an exiting thread back to the shared list.
+    struct cache_release {
+        thread_cache& cache;
+
+        ~cache_release() {
+            instance().drain(cache, cache.count);
+            cache.retired = true;
+        }
+    };
+
+    static constexpr size_t chunk_slots = std::max<size_t>((1 << 16) / sizeof(slot), 1);
+    static constexpr size_t batch_slots = std::min<size_t>(chunk_slots, 64);
+
+    static type_stable_pool& instance() {
+        // Never destroyed: objects may be freed after static destructors run.
+        static type_stable_pool* pool = new type_stable_pool();
+        return *pool;
+    }
+
+    static thread_cache& local_cache() {
+        thread_local thread_cache cache;
+        thread_local cache_release release{cache};
+        return cache;
+    }
+
+    static slot* slot_of(const T* object) {
+        return reinterpret_cast<slot*>(const_cast<std::byte*>(reinterpret_cast<const std::byte*>(object)));
+    }
+
+    void refill(thread_cache& cache) {
+        std::lock_guard lock(mutex);
+        if (free_list == nullptr) {
+            grow();
+        }
+        // A retired cache is never drained again, so it only takes the slot it hands out.
+        const size_t wanted = cache.retired ? 1 : batch_slots;
+        for (size_t moved = 0; moved < wanted && free_list != nullptr; moved++) {
+            slot* free = free_list;
+            free_list = free->next_free;
+            free->next_free = cache.free_list;
+            cache.free_list = free;
+            ++cache.count;
+        }
+    }
+
+    void drain(thread_cache& cache, size_t count) {
+        std::lock_guard lock(mutex);
+        for (; count != 0 && cache.free_list != nullptr; count--) {
+            slot* free = cache.free_list;
+            cache.free_list = free->next_free;
+            --cache.count;
+            free->next_free = free_list;
+            free_list = free;
+        }
+    }
+
+    void grow() {
+        slot* chunk = static_cast<slot*>(::operator new(chunk_slots * sizeof(slot), std::align_val_t(alignof(slot))));
+        for (size_t i = chunk_slots; i-- > 0;) {
+            slot* fresh = new (chunk + i) slot();
+            fresh->next_free = free_list;
+            free_list = fresh;
+        }
+    }
+
+    std::mutex mutex;
+    slot* free_list = nullptr;
+};
+
+} // detail
+
+// Allocator for acid_lists that hand out weak_iterators. Nodes come from a type_stable_pool,
+// so the memory of a reclaimed node stays a node of the same list type and weak_iterator can
+// check it safely. The memory is kept for reuse by nodes of the same type and never
+// returned. Allocations of more than one object go to operator new.
+template<class T>
+class type_stable_allocator {
+public:
+    using value_type = T;
+
+    type_stable_allocator() = default;
+
+    template<class U>
+    type_stable_allocator(const type_stable_allocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n == 1) {
+            return detail::type_stable_pool<T>::allocate();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n == 1) {
+            detail::type_stable_pool<T>::deallocate(p);
+            return;
+        }
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    template<class U>
+    bool operator==(const type_stable_allocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+namespace detail {
+
+template<class Allocator>
+struct is_type_stable_allocator : std::false_type {};
+
+template<class T>
+struct is_type_stable_allocator<type_stable_allocator<T>> : std::true_type {};
+
+} // detail
+
+} // polyndrom
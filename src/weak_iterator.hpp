@@ -0,0 +1,65 @@
+#pragma once
+
+#include "fwd.hpp"
+#include "list_node.hpp"
+#include "list_iterator.hpp"
+#include "type_stable_allocator.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace polyndrom {
+
+// Position in an acid_list that doesn't keep its node alive, for positions cached for a long
+// time: a list_iterator keeps its node and, through its links, possibly a long run of
+// erased neighbours from being freed. The list must allocate with type_stable_allocator, so
+// that a reclaimed node's memory only ever holds nodes of the same list. The weak iterator
+// keeps the node's address and the generation of its slot, which changes when the node is
+// freed.
+//
+// lock() takes a reference only if the node is still referenced, like borrowed_iterator,
+// and then checks the generation again: a reference taken on a node that has reused the
+// slot meanwhile is dropped. An erased node that is still referenced can be locked, and
+// the iterator moves on from it like any iterator standing on an erased node.
+template<typename List>
+class weak_iterator {
+private:
+    using list_type = List;
+    using node_ptr = detail::consistent_node_ptr<list_type>;
+    using node_type = typename node_ptr::consistent_node;
+    using node_pool = detail::type_stable_pool<node_type>;
+
+    static_assert(detail::is_type_stable_allocator<typename list_type::allocator_type>::value,
+                  "weak_iterator requires a list allocating with type_stable_allocator");
+
+public:
+    weak_iterator() = default;
+
+    // A default-constructed list_iterator gives an expired weak iterator.
+    explicit weak_iterator(const list_iterator<list_type>& it)
+        : node(it.node.get()), generation(node != nullptr ? node_pool::generation(node) : 0) {
+    }
+
+    std::optional<list_iterator<list_type>> lock() const {
+        if (expired()) {
+            return std::nullopt;
+        }
+        node_ptr owned;
+        if (!owned.try_acquire(node) || expired()) {
+            return std::nullopt;
+        }
+        return list_iterator<list_type>(std::move(owned));
+    }
+
+    // Whether the node has been reclaimed. A weak iterator that isn't expired may still
+    // expire before lock() is called.
+    bool expired() const {
+        return node == nullptr || node_pool::generation(node) != generation;
+    }
+
+private:
+    node_type* node = nullptr;
+    uint64_t generation = 0;
+};
+
+} // polyndrom
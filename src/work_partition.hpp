@@ -0,0 +1,191 @@
+#pragma once
+
+#include "fwd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace polyndrom {
+
+// Work-stealing traversal of an acid_list by a fixed number of workers, made by
+// acid_list::partition(). Every worker calls run(worker, fn) on its own thread, and fn(value)
+// is called like by acid_list::traverse, with the element and its successor read-locked.
+//
+// Worker 0 starts with the whole list and the others start by stealing: an idle worker picks
+// the one with the most work left, walks half of its remaining segment and takes the second
+// half by moving the victim's segment end to the split node. Workers claim nodes one by one by
+// tagging them with the pass of the partition and stop at a node claimed by someone else, so
+// segment ends are only hints. A worker that runs past the end of its segment, because the
+// end was erased or the steal came too late, stops at the thief's claims.
+//
+// Every element that is in the list for the whole traversal is visited exactly once, and
+// elements inserted or erased meanwhile at most once, including inside claimed segments.
+// Elements moved with splice during the traversal may be missed. Partitioned traversals of
+// one list are serialized, as concurrent ones would mix up their claims: a partition keeps the
+// next one waiting until it is destroyed. A thread holding a partition would thus wait for
+// itself if it made another of the same list, which debug builds assert against.
+template<class List>
+class work_partition {
+    using list_type = List;
+    using node_ptr = typename list_type::node_ptr;
+
+public:
+    // Workers publish their position and pick up steals every publish_interval nodes, and
+    // segments with less than twice that left aren't stolen from.
+    static constexpr size_t publish_interval = 64;
+
+    work_partition(const work_partition&) = delete;
+    work_partition& operator=(const work_partition&) = delete;
+
+    ~work_partition() {
+        list.partition_owner.store(std::thread::id(), std::memory_order_relaxed);
+    }
+
+    size_t workers_count() const {
+        return segments.size();
+    }
+
+    // Visits the worker's segment and then steals until there is nothing left worth stealing.
+    template<class Fn>
+    void run(size_t worker, Fn fn) {
+        segment& own = segments[worker];
+        do {
+            traverse_segment(own, fn);
+        } while (steal(own));
+    }
+
+private:
+    friend list_type;
+
+    struct alignas(64) segment {
+        std::mutex mutex;
+        // The next node to visit, null once the segment is done, and the node it ends before.
+        node_ptr position;
+        node_ptr end;
+        std::atomic_size_t remaining = 0;
+    };
+
+    work_partition(const list_type& list, size_t workers_count)
+        : list(list), list_lock(lock_partitions(list)), segments(std::max<size_t>(workers_count, 1)) {
+        pass = list.next_partition_pass();
+        segment& whole = segments.front();
+        whole.position = list.first.locked_read_next();
+        whole.end = list.last;
+        whole.remaining = static_cast<size_t>(list.size());
+    }
+
+    static std::unique_lock<std::mutex> lock_partitions(const list_type& list) {
+        assert(list.partition_owner.load(std::memory_order_relaxed) != std::this_thread::get_id());
+        std::unique_lock lock(list.partition_mutex);
+        list.partition_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        return lock;
+    }
+
+    template<class Fn>
+    void traverse_segment(segment& own, Fn& fn) {
+        node_ptr start;
+        node_ptr end;
+        {
+            std::lock_guard lock(own.mutex);
+            start = own.position;
+            end = own.end;
+        }
+        if (start == nullptr) {
+            return;
+        }
+        size_t since_publish = 0;
+        list.traverse_nodes(std::move(start), list.last.get(), [&](auto* node) {
+            if (++since_publish == publish_interval) {
+                since_publish = 0;
+                std::lock_guard lock(own.mutex);
+                // node and its successor are read-locked, so the successor links back to node.
+                own.position = node->next->prev;
+                own.remaining = own.remaining - std::min<size_t>(own.remaining, publish_interval);
+                end = own.end;
+            }
+            if (node == end.get() || node->claim_mark.exchange(pass) == pass) {
+                return false;
+            }
+            fn(list_type::read_value(node));
+            return true;
+        });
+        std::lock_guard lock(own.mutex);
+        own.position = nullptr;
+        own.remaining = 0;
+    }
+
+    bool steal(segment& own) {
+        while (true) {
+            segment* victim = nullptr;
+            size_t most_remaining = 2 * publish_interval - 1;
+            for (segment& other : segments) {
+                size_t remaining = other.remaining.load(std::memory_order_relaxed);
+                if (&other != &own && remaining > most_remaining) {
+                    victim = &other;
+                    most_remaining = remaining;
+                }
+            }
+            if (victim == nullptr) {
+                return false;
+            }
+
+            node_ptr position;
+            node_ptr end;
+            size_t remaining;
+            {
+                std::lock_guard lock(victim->mutex);
+                position = victim->position;
+                end = victim->end;
+                remaining = victim->remaining;
+            }
+            if (position == nullptr) {
+                continue;
+            }
+
+            // The victim keeps going meanwhile; if it gets past the split node first, the
+            // claims sort out who visits what.
+            size_t half = remaining / 2;
+            size_t walked = 0;
+            node_ptr split;
+            list.traverse_nodes(position, end.get(), [&](auto* node) {
+                if (walked++ == half) {
+                    split = node->next->prev;
+                    return false;
+                }
+                return true;
+            });
+
+            {
+                std::lock_guard lock(victim->mutex);
+                if (victim->end != end || victim->position == nullptr) {
+                    continue;
+                }
+                if (split == nullptr) {
+                    victim->remaining = std::min<size_t>(victim->remaining, walked);
+                    continue;
+                }
+                victim->end = split;
+                victim->remaining = std::min<size_t>(victim->remaining, half);
+            }
+            std::lock_guard lock(own.mutex);
+            own.position = std::move(split);
+            own.end = std::move(end);
+            own.remaining = remaining - half;
+            return true;
+        }
+    }
+
+    const list_type& list;
+    std::unique_lock<std::mutex> list_lock;
+    uint32_t pass = 0;
+    std::vector<segment> segments;
+};
+
+} // polyndrom
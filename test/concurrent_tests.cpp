@@ -1,4 +1,6 @@
 #include "acid_list.hpp"
+#include "concurrent_lru.hpp"
+#include "priority_list.hpp"
 #include "utils.hpp"
 
 #include "gtest/gtest.h"
@@ -9,6 +11,8 @@
 #include <thread>
 #include <random>
 #include <barrier>
+#include <span>
+#include <bit>
 
 using iterator = typename polyndrom::acid_list<int64_t>::iterator;
 
@@ -304,3 +308,774 @@ TEST(ConcurrentListTest, ParallelErase) {
     EXPECT_EQ(list.size(), threads_count - 1);
     EXPECT_TRUE(std::equal(list.begin(), list.end(), borders.begin()));
 }
+
+TEST(ConcurrentListTest, BorrowedScanWithErase) {
+    const size_t data_size = 200000;
+    const size_t scanners_count = 2;
+    const size_t erasers_count = 2;
+    polyndrom::acid_list<int64_t> list;
+    for (size_t i = 0; i < data_size; i++) {
+        list.push_back(i);
+    }
+    std::vector<iterator> positions = MakeRandomIteratorsVector(list, data_size);
+    const size_t data_per_eraser = data_size / erasers_count;
+    WorkerPool pool(scanners_count + erasers_count);
+    for (size_t i = 0; i < erasers_count; i++) {
+        pool.SubmitWorker([&list, &positions, i, data_per_eraser]() {
+            for (size_t j = data_per_eraser * i; j != data_per_eraser * (i + 1); j++) {
+                list.erase(positions[j]);
+                positions[j] = iterator();
+            }
+        });
+    }
+    for (size_t i = 0; i < scanners_count; i++) {
+        pool.SubmitWorker([&list]() {
+            while (list.size() != 0) {
+                auto scope = list.borrow();
+                int64_t prev = -1;
+                for (auto it = scope.begin(); it != scope.end(); ++it) {
+                    EXPECT_LT(prev, *it);
+                    prev = *it;
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_EQ(list.size(), 0);
+}
+
+TEST(ConcurrentListTest, SnapshotIsConsistent) {
+    const int64_t window_size = 1000;
+    const int64_t shifts_count = 100000;
+    const size_t readers_count = 3;
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < window_size; i++) {
+        list.push_back(i);
+    }
+    std::atomic_bool done = false;
+    WorkerPool pool(readers_count + 1);
+    pool.SubmitWorker([&list, &done, window_size, shifts_count]() {
+        for (int64_t i = window_size; i < window_size + shifts_count; i++) {
+            list.push_back(i);
+            list.erase(list.begin());
+        }
+        done = true;
+    });
+    for (size_t i = 0; i < readers_count; i++) {
+        pool.SubmitWorker([&list, &done, window_size]() {
+            while (!done) {
+                auto values = list.snapshot();
+                ASSERT_TRUE(values.size() == window_size || values.size() == window_size + 1);
+                for (size_t j = 1; j < values.size(); j++) {
+                    ASSERT_EQ(values[j - 1] + 1, values[j]);
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_EQ(list.size(), window_size);
+}
+
+TEST(ConcurrentListTest, AsyncProducersConsumers) {
+    const size_t producers_count = 4;
+    const size_t consumers_count = 8;
+    const int64_t data_per_producer = 50000;
+    polyndrom::acid_list<int64_t> list;
+    std::atomic<int64_t> consumed_sum = 0;
+    std::atomic<size_t> finished_consumers = 0;
+    auto consumer = [](polyndrom::acid_list<int64_t>& list, std::atomic<int64_t>& sum,
+                       std::atomic<size_t>& finished) -> DetachedTask {
+        while (true) {
+            int64_t value = co_await list.async_pop_front();
+            if (value < 0) {
+                break;
+            }
+            sum += value;
+        }
+        ++finished;
+    };
+    for (size_t i = 0; i < consumers_count; i++) {
+        consumer(list, consumed_sum, finished_consumers);
+    }
+    WorkerPool pool(producers_count);
+    for (size_t i = 0; i < producers_count; i++) {
+        pool.SubmitWorker([&list, i, data_per_producer]() {
+            const int64_t producer = static_cast<int64_t>(i);
+            for (int64_t value = data_per_producer * producer; value < data_per_producer * (producer + 1); value++) {
+                list.push_back(value);
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    for (size_t i = 0; i < consumers_count; i++) {
+        list.push_back(-1);
+    }
+    const int64_t total = data_per_producer * producers_count;
+    EXPECT_EQ(finished_consumers, consumers_count);
+    EXPECT_EQ(consumed_sum, total * (total - 1) / 2);
+    EXPECT_EQ(list.size(), 0);
+}
+
+TEST(ConcurrentListTest, ConcurrentElementUpdates) {
+    const size_t threads_count = 4;
+    const int64_t updates_per_thread = 100000;
+    polyndrom::acid_list<int64_t> counters;
+    polyndrom::acid_list<std::pair<int64_t, int64_t>> pairs;
+    counters.push_back(0);
+    pairs.push_back(std::make_pair(int64_t{0}, int64_t{0}));
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&counters, &pairs, i, updates_per_thread]() {
+            const auto counter = counters.begin();
+            const auto pair = pairs.begin();
+            for (int64_t j = 0; j < updates_per_thread; j++) {
+                if (i % 2 == 0) {
+                    counters.fetch_add(counter, 1);
+                } else {
+                    counters.update(counter, [](int64_t& value) {
+                        ++value;
+                    });
+                }
+                pairs.update(pair, [](std::pair<int64_t, int64_t>& value) {
+                    ++value.first;
+                    ++value.second;
+                });
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_EQ(*counters.begin(), threads_count * updates_per_thread);
+    EXPECT_EQ(pairs.begin()->first, threads_count * updates_per_thread);
+    EXPECT_EQ(pairs.begin()->second, threads_count * updates_per_thread);
+}
+
+TEST(ConcurrentListTest, SlidingWindowReplace) {
+    const size_t threads_count = 4;
+    const int64_t window = 16;
+    const int64_t ticks = 20000;
+    polyndrom::acid_list<int64_t> list;
+    // Every thread owns the window in front of its guard node, so neighbouring windows share
+    // their boundary locks.
+    std::vector<iterator> guards;
+    for (size_t i = 0; i < threads_count; i++) {
+        guards.push_back(list.insert(list.end(), -1));
+    }
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&list, &guards, i, window, ticks]() {
+            iterator window_begin = guards[i];
+            std::vector<int64_t> values(window);
+            for (int64_t tick = 0; tick < ticks; tick++) {
+                std::fill(values.begin(), values.end(), tick);
+                window_begin = list.replace_range(window_begin, guards[i], values.begin(), values.end());
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    std::vector<int64_t> expected;
+    for (size_t i = 0; i < threads_count; i++) {
+        expected.insert(expected.end(), window, ticks - 1);
+        expected.push_back(-1);
+    }
+    EXPECT_EQ(list.snapshot(), expected);
+    EXPECT_EQ(list.size(), expected.size());
+}
+
+TEST(ConcurrentListTest, TraverseWithErase) {
+    const size_t readers_count = 2;
+    const size_t writers_count = 2;
+    const int64_t n = 200000;
+    polyndrom::acid_list<int64_t> list;
+    std::vector<iterator> iterators;
+    for (int64_t i = 0; i < n; i++) {
+        iterators.push_back(list.insert(list.end(), i));
+    }
+    std::atomic<bool> ordered = true;
+    WorkerPool pool(readers_count + writers_count);
+    for (size_t i = 0; i < writers_count; i++) {
+        pool.SubmitWorker([&list, &iterators, i, writers_count]() {
+            for (size_t j = i; j < iterators.size(); j += writers_count) {
+                list.erase(iterators[j]);
+            }
+        });
+    }
+    for (size_t i = 0; i < readers_count; i++) {
+        pool.SubmitWorker([&list, &ordered]() {
+            for (int pass = 0; pass < 20; pass++) {
+                int64_t prev = -1;
+                list.traverse([&prev, &ordered](int64_t value) {
+                    if (value <= prev) {
+                        ordered = false;
+                    }
+                    prev = value;
+                });
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(list.size(), 0);
+}
+
+TEST(ConcurrentListTest, SoaArenaScansWithErase) {
+    const size_t writers_count = 2;
+    const int64_t data_per_writer = 50000;
+    const int64_t total = static_cast<int64_t>(writers_count) * data_per_writer;
+    polyndrom::soa_arena<int64_t> arena;
+    polyndrom::soa_list<int64_t> list;
+    std::atomic<bool> consistent = true;
+    WorkerPool pool(writers_count + 1);
+    for (size_t i = 0; i < writers_count; i++) {
+        pool.SubmitWorker([&list, &arena, i, data_per_writer]() {
+            const int64_t writer = static_cast<int64_t>(i);
+            for (int64_t j = 0; j < data_per_writer; j++) {
+                auto it = list.insert(list.end(), arena.make(writer * data_per_writer + j));
+                if (j % 2 == 0) {
+                    list.erase(it);
+                }
+            }
+        });
+    }
+    // Keys are unique and a record never changes chunks, so one scan may not see a key twice,
+    // even while freed slots are reused, nor any key that was never made.
+    pool.SubmitWorker([&arena, &consistent, total]() {
+        std::vector<int64_t> keys;
+        for (int pass = 0; pass < 100; pass++) {
+            keys.clear();
+            arena.for_each_chunk<0>([&keys](auto column, auto live) {
+                for (size_t word = 0; word < live.size(); word++) {
+                    for (uint64_t bits = live[word]; bits != 0; bits &= bits - 1) {
+                        keys.push_back(column[word * 64 + static_cast<size_t>(std::countr_zero(bits))]);
+                    }
+                }
+            });
+            std::sort(keys.begin(), keys.end());
+            if (std::adjacent_find(keys.begin(), keys.end()) != keys.end() ||
+                (!keys.empty() && (keys.front() < 0 || keys.back() >= total))) {
+                consistent = false;
+            }
+        }
+    });
+    pool.Run();
+    pool.Join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(arena.size(), list.size());
+    EXPECT_EQ(arena.count_if<0>([](int64_t key) { return key % 2 == 0; }), 0);
+    EXPECT_EQ(arena.count_if<0>([](int64_t key) { return key % 2 != 0; }), total / 2);
+}
+
+TEST(ConcurrentListTest, AggregatesWithChurn) {
+    const size_t writers_count = 2;
+    const int64_t stable_count = 10000;
+    const int64_t churn_per_writer = 20000;
+    polyndrom::acid_list<int64_t> list;
+    std::vector<iterator> positions;
+    for (int64_t i = 0; i < stable_count; i++) {
+        positions.push_back(list.insert(list.end(), 7));
+    }
+    std::atomic<bool> consistent = true;
+    WorkerPool pool(writers_count + 1);
+    for (size_t i = 0; i < writers_count; i++) {
+        pool.SubmitWorker([&list, &positions, i, churn_per_writer]() {
+            std::mt19937 engine(i);
+            std::uniform_int_distribution<size_t> distribution(0, positions.size() - 1);
+            for (int64_t j = 0; j < churn_per_writer; j++) {
+                list.erase(list.insert(positions[distribution(engine)], 1));
+            }
+        });
+    }
+    pool.SubmitWorker([&list, &consistent, stable_count]() {
+        for (int pass = 0; pass < 50; pass++) {
+            if (list.count(7) != stable_count || *list.max() != 7 || *list.find(7) != 7) {
+                consistent = false;
+            }
+        }
+    });
+    pool.Run();
+    pool.Join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(list.sum(), 7 * stable_count);
+}
+
+TEST(ConcurrentListTest, FindWithElementUpdates) {
+    const int64_t updates = 200000;
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < 1000; i++) {
+        list.push_back(i);
+    }
+    // find() walks its batch again from the start, across the element being updated.
+    auto counter = std::next(list.begin(), 500);
+    std::atomic<bool> consistent = true;
+    WorkerPool pool(2);
+    pool.SubmitWorker([&list, &counter, updates]() {
+        for (int64_t i = 0; i < updates; i++) {
+            list.fetch_add(counter, int64_t{1} << 32);
+        }
+    });
+    pool.SubmitWorker([&list, &consistent]() {
+        for (int pass = 0; pass < 2000; pass++) {
+            if (*list.find(510) != 510) {
+                consistent = false;
+            }
+        }
+    });
+    pool.Run();
+    pool.Join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(list.load(counter), 500 + (updates << 32));
+}
+
+TEST(ConcurrentListTest, BoundedProducersConsumers) {
+    const size_t producers_count = 2;
+    const size_t consumers_count = 2;
+    const int64_t data_per_producer = 50000;
+    const size_t capacity = 64;
+    polyndrom::acid_list<int64_t> list(polyndrom::list_capacity::elements(capacity));
+    std::atomic<int64_t> consumed_count = 0;
+    std::atomic<int64_t> consumed_sum = 0;
+    std::atomic<bool> overflowed = false;
+    const int64_t total = data_per_producer * producers_count;
+    WorkerPool pool(producers_count + consumers_count);
+    for (size_t i = 0; i < producers_count; i++) {
+        pool.SubmitWorker([&list, &overflowed, i, data_per_producer, capacity]() {
+            for (int64_t j = 0; j < data_per_producer; j++) {
+                list.push_back(static_cast<int64_t>(i) * data_per_producer + j);
+                if (static_cast<size_t>(list.size()) > capacity) {
+                    overflowed = true;
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < consumers_count; i++) {
+        pool.SubmitWorker([&list, &consumed_count, &consumed_sum, total]() {
+            while (consumed_count < total) {
+                if (auto value = list.try_pop_front()) {
+                    consumed_sum += *value;
+                    ++consumed_count;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_FALSE(overflowed);
+    EXPECT_EQ(consumed_sum, total * (total - 1) / 2);
+    EXPECT_EQ(list.size(), 0);
+}
+
+TEST(ConcurrentListTest, CompactWithIterators) {
+    using List = polyndrom::acid_list<uint16_t>;
+    const size_t threads_count = 3;
+    const size_t data_per_thread = 20000;
+    const size_t baseline = List::unreclaimed_of_type().nodes;
+    {
+        List list;
+        list.track_erased(true);
+        std::atomic<size_t> finished_writers = 0;
+        WorkerPool pool(threads_count + 1);
+        for (size_t i = 0; i < threads_count; i++) {
+            pool.SubmitWorker([&list, &finished_writers, data_per_thread]() {
+                std::vector<List::iterator> stale;
+                for (size_t j = 0; j < data_per_thread; j++) {
+                    auto it = list.insert(list.end(), static_cast<uint16_t>(j));
+                    if (j % 100 == 0) {
+                        stale.push_back(it);
+                    }
+                    list.erase(it);
+                    if (j % 1000 == 0) {
+                        for (auto& position : stale) {
+                            if (position != list.end()) {
+                                ++position;
+                            }
+                        }
+                    }
+                }
+                ++finished_writers;
+            });
+        }
+        pool.SubmitWorker([&list, &finished_writers, threads_count]() {
+            while (finished_writers != threads_count) {
+                list.compact();
+                list.traverse([](uint16_t) {});
+            }
+        });
+        pool.Run();
+        pool.Join();
+        EXPECT_EQ(list.compact(), 0);
+    }
+    EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline);
+}
+
+TEST(ConcurrentListTest, IntrusiveInsertErase) {
+    struct Item {
+        int64_t value = 0;
+        polyndrom::intrusive_hook<> hook;
+    };
+    const size_t threads_count = 4;
+    const size_t items_per_thread = 64;
+    const size_t rounds = 2000;
+    polyndrom::intrusive_list<Item, &Item::hook> list;
+    std::vector<std::vector<Item>> items(threads_count);
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        items[i] = std::vector<Item>(items_per_thread);
+        pool.SubmitWorker([&list, &own = items[i], rounds]() {
+            std::mt19937 engine(std::random_device{}());
+            std::vector<polyndrom::intrusive_list<Item, &Item::hook>::iterator> positions;
+            for (size_t round = 0; round < rounds; round++) {
+                Item& item = own[engine() % own.size()];
+                if (!item.hook.in_use()) {
+                    item.value = static_cast<int64_t>(round);
+                    positions.push_back(list.insert(list.end(), item));
+                } else {
+                    list.erase(item);
+                }
+                if (positions.size() > 8) {
+                    auto it = positions[engine() % positions.size()];
+                    if (it != list.end()) {
+                        ++it;
+                    }
+                    positions.erase(positions.begin());
+                }
+            }
+            positions.clear();
+            for (Item& item : own) {
+                list.erase(item);
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_EQ(list.begin(), list.end());
+    for (auto& own : items) {
+        for (Item& item : own) {
+            EXPECT_FALSE(item.hook.in_use());
+        }
+    }
+}
+
+TEST(ConcurrentListTest, LruGetPutErase) {
+    const size_t threads_count = 4;
+    const size_t ops_per_thread = 50000;
+    const size_t capacity = 256;
+    polyndrom::concurrent_lru<int64_t, int64_t> cache(capacity, 8);
+    std::atomic<bool> inconsistent = false;
+    std::atomic<size_t> gets = 0;
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&cache, &inconsistent, &gets, ops_per_thread, capacity]() {
+            std::mt19937 engine(std::random_device{}());
+            std::uniform_int_distribution<int64_t> keys(0, static_cast<int64_t>(capacity) * 2);
+            for (size_t j = 0; j < ops_per_thread; j++) {
+                int64_t key = keys(engine);
+                switch (engine() % 8) {
+                    case 0:
+                        cache.erase(key);
+                        break;
+                    case 1:
+                    case 2:
+                        cache.put(key, key * 3);
+                        break;
+                    default:
+                        ++gets;
+                        if (auto value = cache.get(key); value && *value != key * 3) {
+                            inconsistent = true;
+                        }
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_FALSE(inconsistent);
+    EXPECT_LE(cache.size(), capacity);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, gets);
+    EXPECT_GT(stats.evictions, 0);
+}
+
+TEST(ConcurrentListTest, PartitionedTraversalWithChurn) {
+    const size_t workers_count = 4;
+    const int64_t initial_size = 200000;
+    const int64_t churn_size = 20000;
+    polyndrom::acid_list<int64_t> list;
+    std::vector<iterator> churned;
+    for (int64_t i = 0; i < initial_size; i++) {
+        auto it = list.insert(list.end(), i);
+        if (i % 10 == 0) {
+            churned.push_back(it);
+        }
+    }
+    std::vector<std::atomic<int>> visits(initial_size + churn_size);
+    auto work = list.partition(workers_count);
+    WorkerPool pool(workers_count + 1);
+    for (size_t i = 0; i < workers_count; i++) {
+        pool.SubmitWorker([&work, &visits, i]() {
+            work.run(i, [&visits](int64_t value) {
+                ++visits[value];
+            });
+        });
+    }
+    pool.SubmitWorker([&list, &churned, initial_size, churn_size]() {
+        for (int64_t i = 0; i < churn_size; i++) {
+            iterator& pos = churned[i % churned.size()];
+            if (i % 2 == 0) {
+                list.insert(pos, initial_size + i);
+            } else {
+                pos = list.erase(pos);
+            }
+        }
+    });
+    pool.Run();
+    pool.Join();
+    // Initial elements still in the list were there for the whole traversal.
+    size_t twice = 0;
+    size_t missed = 0;
+    std::vector<bool> present(initial_size + churn_size, false);
+    for (int64_t value : list) {
+        present[value] = true;
+    }
+    for (int64_t i = 0; i < initial_size + churn_size; i++) {
+        twice += visits[i] > 1;
+        missed += i < initial_size && present[i] && visits[i] == 0;
+    }
+    EXPECT_EQ(twice, 0);
+    EXPECT_EQ(missed, 0);
+}
+
+TEST(ConcurrentListTest, HotSpotWithBackoff) {
+    const size_t threads_count = 4;
+    const int64_t rounds = 5000;
+    for (auto contention : {polyndrom::contention_policy::none(), polyndrom::contention_policy::exponential(),
+                            polyndrom::contention_policy::escalating()}) {
+        polyndrom::acid_list<int64_t> list(contention);
+        list.push_back(-1);
+        WorkerPool pool(threads_count);
+        for (size_t i = 0; i < threads_count; i++) {
+            pool.SubmitWorker([&list, rounds, i]() {
+                for (int64_t value = 0; value < rounds; value++) {
+                    auto it = list.insert(list.begin(), rounds * i + value);
+                    list.erase(it);
+                    list.erase(list.insert(std::prev(list.end()), value));
+                }
+            });
+        }
+        pool.Run();
+        pool.Join();
+        ASSERT_EQ(list.size(), 1);
+        EXPECT_EQ(*list.begin(), -1);
+    }
+}
+
+TEST(ConcurrentListTest, BatchIterationWithChurn) {
+    const size_t writers_count = 2;
+    const int64_t n = 20000;
+    // Even values stay in the list, odd ones are inserted and erased meanwhile.
+    polyndrom::acid_list<int64_t> list;
+    std::vector<iterator> positions;
+    for (int64_t i = 0; i < n; i++) {
+        positions.push_back(list.insert(list.end(), 2 * i));
+    }
+    std::atomic<bool> consistent = true;
+    WorkerPool pool(writers_count + 2);
+    for (size_t i = 0; i < writers_count; i++) {
+        pool.SubmitWorker([&list, &positions, i, writers_count]() {
+            for (size_t j = i; j < positions.size(); j += writers_count) {
+                auto it = list.insert(positions[j], 2 * static_cast<int64_t>(j) - 1);
+                if (j % 3 != 0) {
+                    list.erase(it);
+                }
+            }
+        });
+    }
+    auto check = [&consistent, n](const std::vector<int64_t>& visited, bool reverse) {
+        std::vector<int64_t> stable;
+        for (int64_t value : visited) {
+            if (value % 2 == 0) {
+                stable.push_back(value);
+            }
+        }
+        std::vector<int64_t> sorted = visited;
+        std::sort(sorted.begin(), sorted.end());
+        if (reverse) {
+            std::reverse(stable.begin(), stable.end());
+        }
+        if (static_cast<int64_t>(stable.size()) != n || !std::is_sorted(stable.begin(), stable.end()) ||
+            std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+            consistent = false;
+        }
+    };
+    pool.SubmitWorker([&list, &check]() {
+        for (int pass = 0; pass < 10; pass++) {
+            std::vector<int64_t> visited;
+            list.for_each_batch(list.begin(), list.end(), 64, [&visited](std::span<const int64_t> batch) {
+                visited.insert(visited.end(), batch.begin(), batch.end());
+            });
+            check(visited, false);
+        }
+    });
+    pool.SubmitWorker([&list, &check]() {
+        for (int pass = 0; pass < 10; pass++) {
+            std::vector<int64_t> visited;
+            list.reverse_for_each_batch(list.begin(), list.end(), 64, [&visited](std::span<const int64_t> batch) {
+                visited.insert(visited.end(), batch.begin(), batch.end());
+            });
+            check(visited, true);
+        }
+    });
+    pool.Run();
+    pool.Join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(list.size(), n + (n + 2) / 3);
+}
+
+TEST(ConcurrentListTest, PriorityListProducersConsumers) {
+    const size_t producers_count = 3;
+    const size_t consumers_count = 3;
+    const int64_t per_producer = 20000;
+    for (auto mode : {polyndrom::delete_mode::relaxed, polyndrom::delete_mode::strict}) {
+        polyndrom::concurrent_priority_list<int64_t, int64_t> queue(mode, 4);
+        std::vector<std::atomic<int>> taken(producers_count * per_producer);
+        std::atomic<int64_t> remaining = producers_count * per_producer;
+        WorkerPool pool(producers_count + consumers_count);
+        for (size_t i = 0; i < producers_count; i++) {
+            pool.SubmitWorker([&queue, per_producer, i]() {
+                std::mt19937 engine(static_cast<uint32_t>(i));
+                for (int64_t j = 0; j < per_producer; j++) {
+                    queue.insert(static_cast<int64_t>(engine() % 1000), per_producer * static_cast<int64_t>(i) + j);
+                }
+            });
+        }
+        for (size_t i = 0; i < consumers_count; i++) {
+            pool.SubmitWorker([&queue, &taken, &remaining]() {
+                while (remaining > 0) {
+                    if (auto entry = queue.delete_min()) {
+                        ++taken[entry->value];
+                        --remaining;
+                    }
+                }
+            });
+        }
+        pool.Run();
+        pool.Join();
+        EXPECT_TRUE(queue.empty());
+        EXPECT_EQ(std::count_if(taken.begin(), taken.end(), [](const std::atomic<int>& count) {
+            return count == 1;
+        }), static_cast<ptrdiff_t>(taken.size()));
+    }
+}
+
+TEST(ConcurrentListTest, InsertSortedWithErase) {
+    const size_t threads_count = 4;
+    const int64_t per_thread = 3000;
+    polyndrom::acid_list<int64_t> list;
+    std::atomic<int64_t> erased = 0;
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&list, &erased, per_thread, i]() {
+            std::mt19937 engine(static_cast<uint32_t>(i));
+            auto hint = list.end();
+            for (int64_t j = 0; j < per_thread; j++) {
+                auto it = list.insert_sorted(hint, static_cast<int64_t>(engine() % 5000));
+                if (engine() % 4 == 0) {
+                    list.erase(it);
+                    ++erased;
+                } else {
+                    hint = it;
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    std::vector<int64_t> values = list.snapshot();
+    EXPECT_EQ(static_cast<int64_t>(values.size()), static_cast<int64_t>(threads_count) * per_thread - erased);
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(ConcurrentListTest, RollbackAfterConcurrentChanges) {
+    const size_t threads_count = 4;
+    const int64_t ops_per_thread = 20000;
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < 1000; i++) {
+        list.push_back(i);
+    }
+    std::vector<int64_t> initial = list.snapshot();
+    list.track_history(true);
+    auto start = list.checkpoint();
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&list, ops_per_thread, i]() {
+            std::mt19937 engine(static_cast<uint32_t>(i));
+            for (int64_t j = 0; j < ops_per_thread; j++) {
+                auto it = std::next(list.begin(), static_cast<ptrdiff_t>(engine() % 8));
+                switch (engine() % 4) {
+                    case 0:
+                        list.insert(it, -j);
+                        break;
+                    case 1:
+                        list.try_pop_front();
+                        break;
+                    case 2:
+                        if (it != list.end()) {
+                            list.erase(it, std::next(it, 2));
+                        }
+                        break;
+                    default:
+                        if (it != list.end()) {
+                            list.erase(it);
+                        }
+                }
+                list.push_back(j);
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    list.rollback_to(start);
+    EXPECT_EQ(list.snapshot(), initial);
+    EXPECT_EQ(list.size(), static_cast<int>(initial.size()));
+}
+
+TEST(ConcurrentListTest, WeakIteratorsWithChurn) {
+    const size_t threads_count = 4;
+    const int64_t rounds = 20000;
+    using list_type = polyndrom::type_stable_list<int64_t>;
+    list_type list;
+    for (int64_t i = 0; i < 64; i++) {
+        list.push_back(i);
+    }
+    std::atomic<bool> inconsistent = false;
+    WorkerPool pool(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        pool.SubmitWorker([&list, &inconsistent, rounds, i]() {
+            std::mt19937 engine(static_cast<uint32_t>(i));
+            std::vector<std::pair<list_type::weak_iterator, int64_t>> cached;
+            for (int64_t j = 0; j < rounds; j++) {
+                if (i % 2 == 0) {
+                    // Values are unique, so a locked node must still hold the cached value.
+                    auto it = list.insert(list.end(), static_cast<int64_t>(i) * rounds + j + 64);
+                    cached.emplace_back(list_type::weak_iterator(it), *it);
+                    auto& [weak, value] = cached[engine() % cached.size()];
+                    if (auto locked = weak.lock(); locked && list.load(*locked) != value) {
+                        inconsistent = true;
+                    }
+                } else {
+                    list.try_pop_front();
+                }
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    EXPECT_FALSE(inconsistent);
+}
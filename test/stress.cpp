@@ -0,0 +1,258 @@
+#include "stress.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+using List = polyndrom::acid_list<int64_t>;
+using Iterator = List::iterator;
+
+class LinearizabilityChecker {
+public:
+    LinearizabilityChecker(const History& history, const std::vector<int64_t>& initial)
+        : history_(history), initial_(initial) {
+    }
+
+    bool Check() {
+        std::vector<bool> linearized(history_.size(), false);
+        return Search(SequentialListModel(initial_), linearized, history_.size());
+    }
+
+private:
+    bool Search(const SequentialListModel& model, std::vector<bool>& linearized, size_t remaining) {
+        if (remaining == 0) {
+            return true;
+        }
+        // Built with a stream: GCC 12 reports a false -Wrestrict for std::string appends here.
+        std::ostringstream key;
+        for (bool done : linearized) {
+            key << done;
+        }
+        key << model.State();
+        if (!visited_.insert(std::move(key).str()).second) {
+            return false;
+        }
+        uint64_t min_response = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < history_.size(); i++) {
+            if (!linearized[i]) {
+                min_response = std::min(min_response, history_[i].responded);
+            }
+        }
+        for (size_t i = 0; i < history_.size(); i++) {
+            if (linearized[i] || history_[i].invoked > min_response) {
+                continue;
+            }
+            SequentialListModel next_model = model;
+            if (!next_model.Apply(history_[i])) {
+                continue;
+            }
+            linearized[i] = true;
+            if (Search(next_model, linearized, remaining - 1)) {
+                return true;
+            }
+            linearized[i] = false;
+        }
+        return false;
+    }
+
+    const History& history_;
+    const std::vector<int64_t>& initial_;
+    std::unordered_set<std::string> visited_;
+};
+
+OpKind RandomOpKind(std::mt19937& engine, const OperationMix& mix) {
+    std::discrete_distribution<int> distribution({static_cast<double>(mix.insert_weight),
+                                                  static_cast<double>(mix.erase_weight),
+                                                  static_cast<double>(mix.iterate_weight)});
+    return static_cast<OpKind>(distribution(engine));
+}
+
+size_t RandomIndex(std::mt19937& engine, size_t size) {
+    return std::uniform_int_distribution<size_t>(0, size - 1)(engine);
+}
+
+} // namespace
+
+SequentialListModel::SequentialListModel(const std::vector<int64_t>& initial) {
+    int64_t prev = kHead;
+    for (int64_t value : initial) {
+        nodes_[value] = Node{prev, kEnd, false};
+        Next(prev) = value;
+        prev = value;
+    }
+    end_prev_ = prev;
+}
+
+int64_t& SequentialListModel::Next(int64_t value) {
+    return value == kHead ? head_next_ : nodes_.at(value).next;
+}
+
+int64_t& SequentialListModel::Prev(int64_t value) {
+    return value == kEnd ? end_prev_ : nodes_.at(value).prev;
+}
+
+bool SequentialListModel::Apply(const Operation& op) {
+    switch (op.kind) {
+        case OpKind::Insert: {
+            int64_t node = op.position;
+            while (node != kEnd && nodes_.at(node).deleted) {
+                node = nodes_.at(node).next;
+            }
+            int64_t prev = Prev(node);
+            nodes_[op.value] = Node{prev, node, false};
+            Next(prev) = op.value;
+            Prev(node) = op.value;
+            return true;
+        }
+        case OpKind::Erase: {
+            Node& node = nodes_.at(op.value);
+            if (node.deleted) {
+                return op.result == kEnd;
+            }
+            node.deleted = true;
+            Next(node.prev) = node.next;
+            Prev(node.next) = node.prev;
+            return op.result == node.next;
+        }
+        case OpKind::Snapshot:
+            return Contents() == op.contents;
+    }
+    return false;
+}
+
+std::vector<int64_t> SequentialListModel::Contents() const {
+    std::vector<int64_t> contents;
+    for (int64_t node = head_next_; node != kEnd; node = nodes_.at(node).next) {
+        contents.push_back(node);
+    }
+    return contents;
+}
+
+std::string SequentialListModel::State() const {
+    std::vector<int64_t> state = {head_next_, end_prev_};
+    for (const auto& [value, node] : nodes_) {
+        state.insert(state.end(), {value, node.prev, node.next, node.deleted});
+    }
+    return std::string(reinterpret_cast<const char*>(state.data()), state.size() * sizeof(int64_t));
+}
+
+bool IsLinearizable(const History& history, const std::vector<int64_t>& initial) {
+    return LinearizabilityChecker(history, initial).Check();
+}
+
+History RecordHistory(size_t threads_count, size_t ops_per_thread, const std::vector<int64_t>& initial,
+                      const OperationMix& mix) {
+    List list;
+    std::copy(initial.begin(), initial.end(), std::back_inserter(list));
+    std::vector<std::pair<int64_t, Iterator>> initial_positions;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        initial_positions.emplace_back(*it, it);
+    }
+    std::atomic<uint64_t> clock = 0;
+    std::vector<History> histories(threads_count);
+    WorkerPool pool(threads_count);
+    for (size_t thread = 0; thread < threads_count; thread++) {
+        pool.SubmitWorker([&, thread]() {
+            std::mt19937 engine(std::random_device{}());
+            auto known = initial_positions;
+            int64_t next_value = static_cast<int64_t>(1000000 * (thread + 1));
+            for (size_t i = 0; i < ops_per_thread; i++) {
+                Operation op;
+                op.thread = thread;
+                op.kind = RandomOpKind(engine, mix);
+                if (op.kind == OpKind::Erase && known.empty()) {
+                    op.kind = OpKind::Snapshot;
+                }
+                switch (op.kind) {
+                    case OpKind::Insert: {
+                        size_t index = RandomIndex(engine, known.size() + 1);
+                        Iterator pos = index == known.size() ? list.end() : known[index].second;
+                        op.value = next_value++;
+                        op.position = index == known.size() ? kEnd : known[index].first;
+                        op.invoked = clock++;
+                        Iterator it = list.insert(pos, op.value);
+                        op.responded = clock++;
+                        known.emplace_back(op.value, it);
+                        break;
+                    }
+                    case OpKind::Erase: {
+                        auto& [value, pos] = known[RandomIndex(engine, known.size())];
+                        op.value = value;
+                        op.invoked = clock++;
+                        Iterator next = list.erase(pos);
+                        op.responded = clock++;
+                        op.result = next == list.end() ? kEnd : *next;
+                        break;
+                    }
+                    case OpKind::Snapshot:
+                        op.invoked = clock++;
+                        op.contents = list.snapshot();
+                        op.responded = clock++;
+                        break;
+                }
+                histories[thread].push_back(std::move(op));
+            }
+        });
+    }
+    pool.Run();
+    pool.Join();
+    History history;
+    for (auto& thread_history : histories) {
+        std::move(thread_history.begin(), thread_history.end(), std::back_inserter(history));
+    }
+    return history;
+}
+
+StressResult RunStress(const StressConfig& config) {
+    const size_t max_known_positions = 1024;
+    List list;
+    for (size_t i = 0; i < config.initial_size; i++) {
+        list.push_back(static_cast<int64_t>(i));
+    }
+    std::vector<Iterator> initial_positions;
+    for (auto it = list.begin(); it != list.end() && initial_positions.size() < max_known_positions; ++it) {
+        initial_positions.push_back(it);
+    }
+    WorkerPool pool(config.threads_count);
+    for (size_t thread = 0; thread < config.threads_count; thread++) {
+        pool.SubmitWorker([&, thread]() {
+            std::mt19937 engine(std::random_device{}());
+            auto known = initial_positions;
+            int64_t next_value = static_cast<int64_t>(config.initial_size + thread * config.ops_per_thread);
+            for (size_t i = 0; i < config.ops_per_thread; i++) {
+                switch (RandomOpKind(engine, config.mix)) {
+                    case OpKind::Insert: {
+                        Iterator pos = known.empty() ? list.end() : known[RandomIndex(engine, known.size())];
+                        Iterator it = list.insert(pos, next_value++);
+                        if (known.size() < max_known_positions) {
+                            known.push_back(it);
+                        } else {
+                            known[RandomIndex(engine, known.size())] = it;
+                        }
+                        break;
+                    }
+                    case OpKind::Erase:
+                        if (!known.empty()) {
+                            list.erase(known[RandomIndex(engine, known.size())]);
+                        }
+                        break;
+                    case OpKind::Snapshot: {
+                        volatile size_t visited = std::distance(list.begin(), list.end());
+                        (void) visited;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    pool.Run();
+    pool.Join();
+    auto finish = std::chrono::steady_clock::now();
+    return {config.threads_count * config.ops_per_thread, std::chrono::duration<double>(finish - start).count()};
+}
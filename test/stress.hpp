@@ -0,0 +1,101 @@
+#pragma once
+
+#include "acid_list.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Positions in a history refer to nodes by their (unique) values; these name the sentinels.
+constexpr int64_t kHead = -1;
+constexpr int64_t kEnd = -2;
+
+enum class OpKind {
+    Insert,
+    Erase,
+    Snapshot
+};
+
+struct Operation {
+    OpKind kind;
+    size_t thread = 0;
+    // Insert: the new value. Erase: the erased node.
+    int64_t value = 0;
+    // Insert: the node the value was inserted before.
+    int64_t position = kEnd;
+    // Erase: the node erase() returned.
+    int64_t result = kEnd;
+    // Snapshot: the observed contents.
+    std::vector<int64_t> contents;
+    uint64_t invoked = 0;
+    uint64_t responded = 0;
+};
+
+using History = std::vector<Operation>;
+
+// Sequential specification of acid_list: erased nodes keep the links they had when they were
+// erased, inserting before an erased node inserts before the first live node following it,
+// and erasing an erased node returns end().
+class SequentialListModel {
+public:
+    explicit SequentialListModel(const std::vector<int64_t>& initial);
+
+    // Applies op and returns whether the observed result matches the model.
+    bool Apply(const Operation& op);
+
+    std::vector<int64_t> Contents() const;
+
+    std::string State() const;
+
+private:
+    struct Node {
+        int64_t prev = kHead;
+        int64_t next = kEnd;
+        bool deleted = false;
+    };
+
+    int64_t& Next(int64_t value);
+    int64_t& Prev(int64_t value);
+
+    std::map<int64_t, Node> nodes_;
+    int64_t head_next_ = kEnd;
+    int64_t end_prev_ = kHead;
+};
+
+// Wing & Gong search for a sequential order of the history that respects real time (an
+// operation that responded before another was invoked comes first) and is accepted by the
+// model, memoizing visited (linearized set, model state) pairs.
+bool IsLinearizable(const History& history, const std::vector<int64_t>& initial);
+
+struct OperationMix {
+    int insert_weight = 1;
+    int erase_weight = 1;
+    int iterate_weight = 1;
+};
+
+struct StressConfig {
+    size_t threads_count = 4;
+    size_t ops_per_thread = 10000;
+    size_t initial_size = 1000;
+    OperationMix mix;
+};
+
+struct StressResult {
+    size_t ops = 0;
+    double seconds = 0;
+
+    double OpsPerSecond() const {
+        return static_cast<double>(ops) / seconds;
+    }
+};
+
+// Runs a random workload with the given mix and thread count against a fresh list and
+// returns the throughput. Iterations walk the whole list with list_iterator.
+StressResult RunStress(const StressConfig& config);
+
+// Runs a short random workload with per-thread histories and logical timestamps. The
+// histories are small enough to be checked with IsLinearizable.
+History RecordHistory(size_t threads_count, size_t ops_per_thread, const std::vector<int64_t>& initial,
+                      const OperationMix& mix);
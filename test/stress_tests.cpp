@@ -0,0 +1,75 @@
+#include "stress.hpp"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <vector>
+
+TEST(LinearizabilityCheckerTest, AcceptsSequentialHistory) {
+    History history = {
+        {.kind = OpKind::Insert, .value = 10, .position = kEnd, .invoked = 0, .responded = 1},
+        {.kind = OpKind::Insert, .value = 11, .position = 10, .invoked = 2, .responded = 3},
+        {.kind = OpKind::Erase, .value = 10, .result = kEnd, .invoked = 4, .responded = 5},
+        {.kind = OpKind::Insert, .value = 12, .position = 10, .invoked = 6, .responded = 7},
+        {.kind = OpKind::Snapshot, .contents = {1, 11, 12}, .invoked = 8, .responded = 9},
+        {.kind = OpKind::Erase, .value = 10, .result = kEnd, .invoked = 10, .responded = 11},
+    };
+    EXPECT_TRUE(IsLinearizable(history, {1}));
+}
+
+TEST(LinearizabilityCheckerTest, ReordersOverlappingOperations) {
+    History history = {
+        {.kind = OpKind::Snapshot, .contents = {1, 2}, .invoked = 0, .responded = 3},
+        {.kind = OpKind::Erase, .thread = 1, .value = 2, .result = kEnd, .invoked = 1, .responded = 4},
+        {.kind = OpKind::Snapshot, .thread = 2, .contents = {1}, .invoked = 2, .responded = 5},
+    };
+    EXPECT_TRUE(IsLinearizable(history, {1, 2}));
+}
+
+TEST(LinearizabilityCheckerTest, RejectsRealTimeViolation) {
+    History history = {
+        {.kind = OpKind::Erase, .value = 2, .result = kEnd, .invoked = 0, .responded = 1},
+        {.kind = OpKind::Snapshot, .thread = 1, .contents = {1, 2}, .invoked = 2, .responded = 3},
+    };
+    EXPECT_FALSE(IsLinearizable(history, {1, 2}));
+}
+
+TEST(LinearizabilityCheckerTest, RejectsWrongErasePosition) {
+    History history = {
+        {.kind = OpKind::Erase, .value = 1, .result = 3, .invoked = 0, .responded = 1},
+    };
+    EXPECT_FALSE(IsLinearizable(history, {1, 2, 3}));
+}
+
+TEST(StressTest, LinearizableHistories) {
+    const size_t rounds_count = 200;
+    const size_t threads_count = 3;
+    const size_t ops_per_thread = 12;
+    const std::vector<int64_t> initial = {1, 2, 3, 4};
+    for (OperationMix mix : {OperationMix{2, 2, 1}, OperationMix{1, 3, 1}, OperationMix{3, 1, 2}}) {
+        for (size_t round = 0; round < rounds_count; round++) {
+            History history = RecordHistory(threads_count, ops_per_thread, initial, mix);
+            ASSERT_TRUE(IsLinearizable(history, initial));
+        }
+    }
+}
+
+TEST(StressTest, Throughput) {
+    const std::vector<std::pair<std::string, OperationMix>> mixes = {
+        {"insert-heavy", {8, 2, 0}},
+        {"erase-heavy", {2, 8, 0}},
+        {"with-iteration", {50, 50, 1}},
+    };
+    for (const auto& [name, mix] : mixes) {
+        for (size_t threads_count : {1, 2, 4}) {
+            StressConfig config;
+            config.threads_count = threads_count;
+            config.ops_per_thread = 10000;
+            config.mix = mix;
+            StressResult result = RunStress(config);
+            EXPECT_EQ(result.ops, threads_count * config.ops_per_thread);
+            std::cout << name << ", " << threads_count << " threads: "
+                      << result.OpsPerSecond() << " ops/sec" << std::endl;
+        }
+    }
+}
@@ -1,4 +1,6 @@
 #include "acid_list.hpp"
+#include "concurrent_lru.hpp"
+#include "priority_list.hpp"
 #include "utils.hpp"
 
 #include "gtest/gtest.h"
@@ -6,6 +8,18 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <sstream>
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <memory_resource>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
 
 using iterator = typename polyndrom::acid_list<int>::iterator;
 
@@ -356,3 +370,1182 @@ TEST(ConsistentListTest, InvalidateRandomReverse) {
         }
     }
 }
+
+TEST(BorrowedIteratorTest, Traverse) {
+    int n = 10000;
+    polyndrom::acid_list<int> list;
+    auto values = RandomIntVector(n);
+    std::copy(values.begin(), values.end(), std::back_inserter(list));
+    auto scope = list.borrow();
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), scope.begin(), scope.end()));
+    EXPECT_TRUE(std::equal(values.rbegin(), values.rend(), std::make_reverse_iterator(scope.end()),
+                           std::make_reverse_iterator(scope.begin())));
+}
+
+TEST(BorrowedIteratorTest, InvalidateAll) {
+    int n = 5000;
+    polyndrom::acid_list<int> list;
+    std::fill_n(std::back_inserter(list), n, 0);
+    std::iota(list.begin(), list.end(), 0);
+    auto scope = list.borrow();
+    std::vector<polyndrom::borrowed_iterator<polyndrom::acid_list<int>>> its;
+    for (auto it = scope.begin(); it != scope.end(); ++it) {
+        its.push_back(it);
+    }
+    list.clear();
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(*its[i], i);
+        EXPECT_EQ(std::next(its[i]), scope.end());
+    }
+}
+
+TEST(BorrowedIteratorTest, ConvertToOwned) {
+    polyndrom::acid_list<int> list;
+    list.push_back(1);
+    list.push_back(2);
+    list.push_back(3);
+    iterator owned;
+    iterator owned_erased;
+    {
+        auto scope = list.borrow();
+        auto it = std::next(scope.begin());
+        owned = iterator(it);
+        auto third = std::next(it);
+        list.erase(iterator(third));
+        EXPECT_EQ(*third, 3);
+        owned_erased = iterator(third);
+        list.erase(owned);
+    }
+    EXPECT_EQ(*owned, 2);
+    EXPECT_EQ(std::next(owned), list.end());
+    EXPECT_EQ(owned_erased, list.end());
+    EXPECT_EQ(*list.begin(), 1);
+    EXPECT_EQ(list.size(), 1);
+}
+
+TEST(NumaPlacementTest, PooledNodes) {
+    int n = 10000;
+    for (auto policy : {polyndrom::numa_policy::local(), polyndrom::numa_policy::bind(0),
+                        polyndrom::numa_policy::interleave()}) {
+        polyndrom::acid_list<int> list(policy);
+        auto values = RandomIntVector(n);
+        std::copy(values.begin(), values.end(), std::back_inserter(list));
+        EXPECT_TRUE(std::equal(values.begin(), values.end(), list.begin()));
+        auto it = std::next(list.begin(), n / 2);
+        list.clear();
+        EXPECT_EQ(*it, values[n / 2]);
+        EXPECT_EQ(++it, list.end());
+        EXPECT_EQ(list.size(), 0);
+    }
+}
+
+TEST(NumaPlacementTest, PooledNodesFreedByOtherThreads) {
+    int n = 1000;
+    polyndrom::acid_list<int> list(polyndrom::numa_policy::local());
+    for (int round = 0; round < 3; round++) {
+        std::thread producer([&list, n]() {
+            for (int i = 0; i < n; i++) {
+                list.push_back(i);
+            }
+        });
+        producer.join();
+        EXPECT_EQ(list.size(), n);
+        list.clear();
+        std::thread consumer([&list, n]() {
+            for (int i = 0; i < n; i++) {
+                list.push_back(i);
+            }
+            list.clear();
+        });
+        consumer.join();
+        EXPECT_EQ(list.size(), 0);
+    }
+}
+
+TEST(NumaPlacementTest, RejectsMissingNode) {
+    const int nodes = polyndrom::numa_nodes_count();
+    EXPECT_THROW(polyndrom::numa_policy::bind(-1), std::out_of_range);
+    EXPECT_THROW(polyndrom::numa_policy::bind(nodes), std::out_of_range);
+    EXPECT_EQ(polyndrom::numa_policy::bind(nodes - 1).node, nodes - 1);
+    for (int node = 0; node < nodes; node++) {
+        if (polyndrom::numa_node_exists(node)) {
+            EXPECT_EQ(polyndrom::numa_policy::bind(node).node, node);
+        } else {
+            EXPECT_THROW(polyndrom::numa_policy::bind(node), std::out_of_range);
+        }
+    }
+
+    polyndrom::acid_list<int> list(polyndrom::numa_policy{polyndrom::numa_placement::bind, nodes});
+    EXPECT_THROW(list.push_back(1), std::out_of_range);
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(SerializationTest, Snapshot) {
+    int n = 10000;
+    polyndrom::acid_list<int> list;
+    auto values = RandomIntVector(n);
+    std::copy(values.begin(), values.end(), std::back_inserter(list));
+    list.erase(list.begin());
+    values.erase(values.begin());
+    EXPECT_EQ(list.snapshot(), values);
+}
+
+TEST(SerializationTest, StreamRoundTrip) {
+    int n = 10000;
+    polyndrom::acid_list<int> list;
+    auto values = RandomIntVector(n);
+    std::copy(values.begin(), values.end(), std::back_inserter(list));
+    std::stringstream stream;
+    list.serialize(stream);
+    polyndrom::acid_list<int> loaded;
+    loaded.push_back(42);
+    loaded.load(stream);
+    values.insert(values.begin(), 42);
+    EXPECT_EQ(loaded.size(), n + 1);
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), loaded.begin(), loaded.end()));
+    EXPECT_EQ(*std::prev(loaded.end()), values.back());
+}
+
+TEST(SerializationTest, FileRoundTrip) {
+    int n = 10000;
+    polyndrom::acid_list<int64_t> list;
+    for (int i = 0; i < n; i++) {
+        list.push_back(i);
+    }
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    list.serialize(fileno(file));
+    polyndrom::acid_list<int64_t> loaded;
+    loaded.load(fileno(file));
+    std::fclose(file);
+    EXPECT_EQ(loaded.size(), n);
+    EXPECT_TRUE(std::equal(list.begin(), list.end(), loaded.begin(), loaded.end()));
+    loaded.push_back(n);
+    EXPECT_EQ(*std::prev(loaded.end()), n);
+}
+
+TEST(SerializationTest, RejectsMismatchedSnapshot) {
+    polyndrom::acid_list<int> list;
+    list.push_back(1);
+    std::stringstream stream;
+    list.serialize(stream);
+    polyndrom::acid_list<int64_t> other;
+    EXPECT_THROW(other.load(stream), std::runtime_error);
+    std::stringstream garbage("not a snapshot at all, definitely");
+    EXPECT_THROW(other.load(garbage), std::runtime_error);
+    EXPECT_EQ(other.size(), 0);
+}
+
+TEST(SerializationTest, RejectsBadCount) {
+    polyndrom::acid_list<int64_t> list;
+    list.push_back(1);
+    std::stringstream stream;
+    list.serialize(stream);
+    const std::string snapshot = stream.str();
+    auto with_count = [&snapshot](uint64_t count) {
+        std::string patched = snapshot;
+        std::memcpy(patched.data() + offsetof(polyndrom::detail::snapshot_header, count), &count, sizeof(count));
+        return std::stringstream(patched);
+    };
+    polyndrom::acid_list<int64_t> loaded;
+    // count * sizeof(int64_t) wraps around to zero.
+    auto huge = with_count(uint64_t{1} << 61);
+    EXPECT_THROW(loaded.load(huge), std::runtime_error);
+    auto truncated = with_count(3);
+    EXPECT_THROW(loaded.load(truncated), std::runtime_error);
+    EXPECT_EQ(loaded.size(), 0);
+    auto exact = with_count(1);
+    loaded.load(exact);
+    EXPECT_EQ(loaded.snapshot(), std::vector<int64_t>({1}));
+}
+
+TEST(AsyncListTest, PopFrontWaitsForInsert) {
+    polyndrom::acid_list<int> list;
+    std::vector<int> popped;
+    auto consumer = [](polyndrom::acid_list<int>& list, std::vector<int>& popped) -> DetachedTask {
+        for (int i = 0; i < 3; i++) {
+            popped.push_back(co_await list.async_pop_front());
+        }
+    };
+    list.push_back(1);
+    consumer(list, popped);
+    EXPECT_EQ(popped, std::vector<int>({1}));
+    list.push_back(2);
+    EXPECT_EQ(popped, std::vector<int>({1, 2}));
+    EXPECT_EQ(list.size(), 0);
+    list.push_front(3);
+    EXPECT_EQ(popped, std::vector<int>({1, 2, 3}));
+    list.push_back(4);
+    EXPECT_EQ(list.size(), 1);
+    EXPECT_EQ(list.try_pop_front(), 4);
+    EXPECT_EQ(list.try_pop_front(), std::nullopt);
+}
+
+TEST(AsyncListTest, WaitNonemptyAndOnInsert) {
+    polyndrom::acid_list<int> list;
+    int nonempty_wakeups = 0;
+    int insert_wakeups = 0;
+    auto wait_nonempty = [](polyndrom::acid_list<int>& list, int& wakeups) -> DetachedTask {
+        co_await list.wait_nonempty();
+        ++wakeups;
+    };
+    auto wait_insert = [](polyndrom::acid_list<int>& list, int& wakeups) -> DetachedTask {
+        co_await list.on_insert();
+        ++wakeups;
+    };
+    wait_nonempty(list, nonempty_wakeups);
+    wait_nonempty(list, nonempty_wakeups);
+    EXPECT_EQ(nonempty_wakeups, 0);
+    list.push_back(1);
+    EXPECT_EQ(nonempty_wakeups, 2);
+    wait_nonempty(list, nonempty_wakeups);
+    EXPECT_EQ(nonempty_wakeups, 3);
+    wait_insert(list, insert_wakeups);
+    EXPECT_EQ(insert_wakeups, 0);
+    list.erase(list.begin());
+    EXPECT_EQ(insert_wakeups, 0);
+    list.push_back(2);
+    EXPECT_EQ(insert_wakeups, 1);
+}
+
+TEST(ElementUpdateTest, UpdateUnderLock) {
+    polyndrom::acid_list<std::string> list;
+    static_assert(!polyndrom::acid_list<std::string>::has_lock_free_values);
+    list.push_back("a");
+    list.push_back("b");
+    auto it = std::next(list.begin());
+    list.update(it, [](std::string& value) {
+        value += "c";
+    });
+    EXPECT_EQ(*it, "bc");
+    list.erase(it);
+    list.update(it, [](std::string& value) {
+        value += "d";
+    });
+    EXPECT_EQ(*it, "bcd");
+    EXPECT_EQ(list.snapshot(), std::vector<std::string>({"a"}));
+}
+
+TEST(ElementUpdateTest, LockFreeOperations) {
+    polyndrom::acid_list<int64_t> list;
+    static_assert(polyndrom::acid_list<int64_t>::has_lock_free_values);
+    list.push_back(1);
+    list.push_back(10);
+    auto it = std::next(list.begin());
+    EXPECT_EQ(list.fetch_add(it, 5), 10);
+    EXPECT_EQ(list.load(it), 15);
+    int64_t expected = 10;
+    EXPECT_FALSE(list.compare_exchange(it, expected, 20));
+    EXPECT_EQ(expected, 15);
+    EXPECT_TRUE(list.compare_exchange(it, expected, 20));
+    list.update(it, [](int64_t& value) {
+        value *= 2;
+    });
+    list.store(list.begin(), 2);
+    EXPECT_EQ(list.snapshot(), std::vector<int64_t>({2, 40}));
+}
+
+TEST(RangeOperationsTest, EraseRange) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 6; i++) {
+        list.push_back(i);
+    }
+    auto range_begin = std::next(list.begin());
+    auto range_end = std::next(list.begin(), 4);
+    auto inside = std::next(list.begin(), 2);
+    auto it = list.erase(range_begin, range_end);
+    EXPECT_EQ(*it, 4);
+    EXPECT_EQ(list.size(), 3);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({0, 4, 5}));
+    ++inside;
+    EXPECT_EQ(*inside, 4);
+    EXPECT_EQ(list.erase(list.begin(), list.begin()), list.begin());
+    EXPECT_EQ(list.erase(list.begin(), list.end()), list.end());
+    EXPECT_EQ(list.size(), 0);
+}
+
+TEST(RangeOperationsTest, EraseRangeEndingBeforeErasedBegin) {
+    polyndrom::acid_list<int> list;
+    for (int value : {1, 2, 4}) {
+        list.push_back(value);
+    }
+    auto range_begin = std::next(list.begin());
+    auto four = std::next(list.begin(), 2);
+    list.erase(range_begin);
+    auto range_end = list.insert(four, 3);
+    EXPECT_EQ(list.erase(range_begin, range_end), range_end);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({1, 3, 4}));
+    std::vector<int> values = {5};
+    EXPECT_EQ(*list.replace_range(range_begin, range_end, values.begin(), values.end()), 5);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({1, 5, 3, 4}));
+}
+
+TEST(RangeOperationsTest, ReplaceRange) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 5; i++) {
+        list.push_back(i);
+    }
+    std::vector<int> values = {10, 11, 12};
+    auto it = list.replace_range(list.begin(), std::next(list.begin(), 2), values.begin(), values.end());
+    EXPECT_EQ(*it, 10);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({10, 11, 12, 2, 3, 4}));
+    auto erased = std::next(list.begin(), 3);
+    list.erase(erased);
+    it = list.replace_range(erased, list.end(), values.begin(), values.begin() + 1);
+    EXPECT_EQ(*it, 10);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({10, 11, 12, 10}));
+    EXPECT_EQ(list.size(), 4);
+}
+
+TEST(RangeOperationsTest, InsertRange) {
+    polyndrom::acid_list<int> list;
+    list.push_back(0);
+    list.push_back(4);
+    std::vector<int> values = {1, 2, 3};
+    auto it = list.insert(std::next(list.begin()), values.begin(), values.end());
+    EXPECT_EQ(*it, 1);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({0, 1, 2, 3, 4}));
+    EXPECT_EQ(list.insert(list.end(), values.end(), values.end()), list.end());
+    EXPECT_EQ(list.size(), 5);
+}
+
+TEST(TraversalTest, HandOverHand) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 10; i++) {
+        list.push_back(i);
+    }
+    std::vector<int> visited;
+    list.traverse([&visited](int value) {
+        visited.push_back(value);
+    });
+    EXPECT_EQ(visited, list.snapshot());
+
+    auto range_begin = std::next(list.begin(), 2);
+    auto range_end = std::next(list.begin(), 5);
+    list.erase(range_begin);
+    visited.clear();
+    list.traverse(range_begin, range_end, [&visited](int value) {
+        visited.push_back(value);
+    });
+    EXPECT_EQ(visited, std::vector<int>({3, 4}));
+
+    polyndrom::acid_list<int> empty;
+    empty.traverse([](int) {
+        FAIL();
+    });
+}
+
+TEST(TraversalTest, ThrowingFnReleasesLocks) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 5; i++) {
+        list.push_back(i);
+    }
+    for (int stop : {0, 3, 4}) {
+        EXPECT_THROW(list.traverse([stop](int value) {
+            if (value == stop) {
+                throw std::runtime_error("stop");
+            }
+        }), std::runtime_error);
+    }
+    // Erasing write-locks every node and its neighbours, so a leaked read lock would hang.
+    for (auto it = list.begin(); it != list.end(); it = list.erase(it));
+    list.push_back(5);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({5}));
+}
+
+TEST(RangeOperationsTest, ErasedRangeIsReleased) {
+    polyndrom::acid_list<std::shared_ptr<int>> list;
+    auto value = std::make_shared<int>(0);
+    for (int i = 0; i < 10; i++) {
+        list.push_back(value);
+    }
+    auto inside = std::next(list.begin(), 5);
+    list.erase(std::next(list.begin()), std::prev(list.end()));
+    EXPECT_EQ(value.use_count(), 7);
+    inside = list.end();
+    EXPECT_EQ(value.use_count(), 3);
+    list.replace_range(list.begin(), list.end(), &value, &value + 1);
+    EXPECT_EQ(value.use_count(), 2);
+}
+
+TEST(SoaArenaTest, RecordsAndScans) {
+    polyndrom::soa_arena<int64_t, double> arena;
+    polyndrom::soa_list<int64_t, double> list;
+    const int64_t n = 3000;
+    for (int64_t i = 0; i < n; i++) {
+        list.push_back(arena.make(i, static_cast<double>(i) / 2));
+    }
+    EXPECT_EQ(arena.size(), n);
+    EXPECT_EQ(arena.count_if<0>([](int64_t key) { return key % 3 == 0; }), 1000);
+    EXPECT_EQ(std::get<1>(*arena.find_if<0>([](int64_t key) { return key == 42; })), 21.0);
+    EXPECT_FALSE(arena.find_if<0>([](int64_t key) { return key == n; }).has_value());
+
+    auto it = std::next(list.begin());
+    EXPECT_EQ(it->get<0>(), 1);
+    it->set<1>(7.5);
+    EXPECT_EQ(it->load(), std::make_tuple(int64_t{1}, 7.5));
+
+    list.erase(list.begin(), std::next(list.begin(), 10));
+    EXPECT_EQ(arena.size(), n - 1);
+    it = list.end();
+    EXPECT_EQ(arena.size(), n - 10);
+    size_t chunks = 0;
+    arena.for_each_chunk<0>([&chunks](auto column, auto live) {
+        EXPECT_EQ(column.size(), decltype(arena)::chunk_capacity);
+        EXPECT_EQ(live.size(), decltype(arena)::mask_words);
+        ++chunks;
+    });
+    EXPECT_EQ(chunks, 3);
+    list.push_back(arena.make(n, 0.0));
+    EXPECT_EQ(arena.count_if<0>([](int64_t key) { return key < 10 || key == n; }), 1);
+}
+
+TEST(AggregateTest, ArithmeticReductions) {
+    polyndrom::acid_list<int64_t> list;
+    EXPECT_EQ(list.find(0), list.end());
+    EXPECT_FALSE(list.min().has_value());
+    EXPECT_EQ(list.sum(), 0);
+    const int64_t n = 1000;
+    for (int64_t i = 0; i < n; i++) {
+        list.push_back(i % 10 == 0 ? -i : i);
+    }
+    EXPECT_EQ(list.count(7), 1);
+    EXPECT_EQ(list.count(n), 0);
+    EXPECT_EQ(*list.find(-990), -990);
+    EXPECT_EQ(list.find(n), list.end());
+    EXPECT_EQ(*list.min(), -990);
+    EXPECT_EQ(*list.max(), 999);
+    EXPECT_EQ(list.sum(), std::accumulate(list.begin(), list.end(), int64_t{0}));
+
+    list.erase(list.find(-300));
+    EXPECT_EQ(list.find(-300), list.end());
+    EXPECT_EQ(list.count(-300), 0);
+
+    polyndrom::acid_list<double> doubles;
+    polyndrom::acid_list<int16_t> shorts;
+    for (int i = 0; i < 100; i++) {
+        doubles.push_back(i * 0.5);
+        shorts.push_back(static_cast<int16_t>(i));
+    }
+    EXPECT_EQ(doubles.count(10.0), 1);
+    EXPECT_EQ(*doubles.max(), 49.5);
+    EXPECT_EQ(doubles.sum(), 2475.0);
+    EXPECT_EQ(*shorts.find(42), 42);
+    EXPECT_EQ(*shorts.min(), 0);
+}
+
+TEST(BoundedListTest, TryPushBack) {
+    polyndrom::acid_list<int> list(polyndrom::list_capacity::elements(3));
+    EXPECT_EQ(list.capacity(), 3);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(list.try_push_back(i));
+    }
+    EXPECT_FALSE(list.try_push_back(3));
+    EXPECT_FALSE(list.try_insert(list.begin(), 3).has_value());
+    list.erase(list.begin());
+    auto it = list.try_insert(list.begin(), 4);
+    ASSERT_TRUE(it.has_value());
+    EXPECT_EQ(**it, 4);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({4, 1, 2}));
+    std::vector<int> values = {5, 6, 7, 8};
+    EXPECT_THROW(list.insert(list.end(), values.begin(), values.end()), std::length_error);
+
+    polyndrom::acid_list<int> unbounded;
+    EXPECT_EQ(unbounded.capacity(), 0);
+    EXPECT_TRUE(unbounded.try_push_back(1));
+}
+
+TEST(BoundedListTest, DropOldest) {
+    polyndrom::acid_list<int> list(polyndrom::list_capacity::elements(3, polyndrom::overflow_policy::drop_oldest));
+    for (int i = 0; i < 10; i++) {
+        list.push_back(i);
+    }
+    EXPECT_EQ(list.snapshot(), std::vector<int>({7, 8, 9}));
+    std::vector<int> values = {10, 11};
+    list.insert(list.end(), values.begin(), values.end());
+    EXPECT_EQ(list.snapshot(), std::vector<int>({9, 10, 11}));
+    list.erase(list.begin(), list.end());
+    EXPECT_TRUE(list.try_push_back(12));
+}
+
+TEST(BoundedListTest, ByteCapacity) {
+    polyndrom::acid_list<int64_t> list(polyndrom::list_capacity::bytes(1 << 12));
+    size_t pushed = 0;
+    while (list.try_push_back(0)) {
+        ++pushed;
+    }
+    EXPECT_EQ(pushed, list.capacity());
+    EXPECT_GT(pushed, 0);
+    EXPECT_LT(pushed, (1 << 12) / sizeof(int64_t));
+}
+
+TEST(ReclamationTest, CompactStaleIterator) {
+    using List = polyndrom::acid_list<uint16_t>;
+    const size_t baseline = List::unreclaimed_of_type().nodes;
+    const size_t node_size = sizeof(polyndrom::detail::consistent_node_ptr<List>::consistent_node);
+    for (bool tracked : {false, true}) {
+        List list;
+        list.track_erased(tracked);
+        std::vector<List::iterator> iterators;
+        for (uint16_t i = 0; i < 10; i++) {
+            iterators.push_back(list.insert(list.end(), i));
+        }
+        auto stale = iterators[2];
+        for (size_t i = 2; i < 8; i++) {
+            list.erase(iterators[i]);
+        }
+        iterators.clear();
+        // The stale iterator pins every node erased after its own.
+        EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline + 6);
+        EXPECT_EQ(List::unreclaimed_of_type().bytes, (baseline + 6) * node_size);
+        if (tracked) {
+            EXPECT_EQ(list.compact(), 1);
+            EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline + 1);
+        } else {
+            EXPECT_EQ(list.compact(), 0);
+            EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline + 6);
+        }
+        auto next = std::next(stale);
+        EXPECT_EQ(*next, 8);
+        EXPECT_EQ(*std::prev(stale), 1);
+        stale = list.end();
+        EXPECT_EQ(list.compact(), 0);
+        EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline);
+    }
+}
+
+TEST(ReclamationTest, TrackedRecordsStayBounded) {
+    using List = polyndrom::acid_list<uint16_t>;
+    const size_t baseline = List::unreclaimed_of_type().nodes;
+    List list;
+    list.track_erased(true);
+    for (uint16_t i = 0; i < 1000; i++) {
+        list.push_back(i);
+    }
+    // Only the records refer to the erased nodes, which are dropped as the records grow.
+    for (auto it = list.begin(); it != list.end(); it = list.erase(it));
+    EXPECT_LT(List::unreclaimed_of_type().nodes, baseline + 64);
+    // Popped nodes are referenced by nothing else once erased and aren't recorded at all.
+    for (uint16_t i = 0; i < 1000; i++) {
+        list.push_back(i);
+        list.try_pop_front();
+    }
+    EXPECT_LT(List::unreclaimed_of_type().nodes, baseline + 64);
+    EXPECT_EQ(list.compact(), 0);
+    EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline);
+
+    // A node pinned by a stale iterator keeps its record, and compact() still reaches it.
+    for (uint16_t i = 0; i < 1000; i++) {
+        list.push_back(i);
+    }
+    auto stale = std::next(list.begin(), 500);
+    for (auto it = list.begin(); it != list.end(); it = list.erase(it));
+    EXPECT_EQ(list.compact(), 1);
+    EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline + 1);
+    stale = list.end();
+    EXPECT_EQ(list.compact(), 0);
+    EXPECT_EQ(List::unreclaimed_of_type().nodes, baseline);
+}
+
+TEST(SingleThreadPolicyTest, ListOperations) {
+    polyndrom::acid_list<int, polyndrom::single_thread_policy> list;
+    for (int i = 0; i < 10; i++) {
+        list.push_back(i);
+    }
+    auto it = std::next(list.begin(), 3);
+    auto erased = std::next(list.begin(), 4);
+    list.erase(erased);
+    list.insert(erased, 40);
+    ++erased;
+    EXPECT_EQ(*erased, 5);
+    list.erase(list.begin(), it);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({3, 40, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(list.size(), 7);
+    EXPECT_EQ(list.count(40), 1);
+
+    polyndrom::acid_list<int, polyndrom::single_thread_policy> bounded(polyndrom::list_capacity::elements(1));
+    bounded.push_back(1);
+    EXPECT_FALSE(bounded.try_push_back(2));
+    EXPECT_THROW(bounded.push_back(2), std::length_error);
+}
+
+TEST(SingleThreadPolicyTest, MoveBetweenPolicies) {
+    polyndrom::acid_list<std::unique_ptr<int>, polyndrom::single_thread_policy> local;
+    for (int i = 0; i < 5; i++) {
+        local.push_back(std::make_unique<int>(i));
+    }
+    polyndrom::acid_list<std::unique_ptr<int>> shared(std::move(local));
+    EXPECT_EQ(local.size(), 0);
+    EXPECT_EQ(shared.size(), 5);
+    int expected = 0;
+    for (const auto& value : shared) {
+        EXPECT_EQ(*value, expected++);
+    }
+    polyndrom::acid_list<std::unique_ptr<int>, polyndrom::single_thread_policy> back(std::move(shared));
+    EXPECT_EQ(back.size(), 5);
+    EXPECT_EQ(shared.size(), 0);
+}
+
+TEST(SingleThreadPolicyTest, MoveKeepsCapacity) {
+    polyndrom::acid_list<int, polyndrom::single_thread_policy> local(polyndrom::list_capacity::elements(3));
+    for (int i = 0; i < 3; i++) {
+        local.push_back(i);
+    }
+    polyndrom::acid_list<int> shared(std::move(local));
+    EXPECT_EQ(shared.capacity(), 3);
+    EXPECT_EQ(shared.size(), 3);
+    EXPECT_FALSE(shared.try_push_back(3));
+    shared.try_pop_front();
+    EXPECT_TRUE(shared.try_push_back(3));
+    EXPECT_FALSE(shared.try_push_back(4));
+    EXPECT_EQ(shared.snapshot(), std::vector<int>({1, 2, 3}));
+
+    // The source's room is given back as it is emptied.
+    EXPECT_TRUE(local.try_push_back(5));
+
+    polyndrom::acid_list<int> dropping(polyndrom::list_capacity::elements(2, polyndrom::overflow_policy::drop_oldest));
+    dropping.push_back(1);
+    polyndrom::acid_list<int, polyndrom::single_thread_policy> back(std::move(dropping));
+    back.push_back(2);
+    back.push_back(3);
+    EXPECT_EQ(back.snapshot(), std::vector<int>({2, 3}));
+}
+
+struct IntrusiveTask {
+    explicit IntrusiveTask(int id) : id(id) {
+    }
+
+    int id;
+    polyndrom::intrusive_hook<> queue_hook;
+    polyndrom::intrusive_hook<> all_hook;
+};
+
+TEST(IntrusiveListTest, ListOperations) {
+    std::vector<std::unique_ptr<IntrusiveTask>> tasks;
+    for (int i = 0; i < 10; i++) {
+        tasks.push_back(std::make_unique<IntrusiveTask>(i));
+    }
+    polyndrom::intrusive_list<IntrusiveTask, &IntrusiveTask::queue_hook> queue;
+    polyndrom::intrusive_list<IntrusiveTask, &IntrusiveTask::all_hook> all;
+    for (auto& task : tasks) {
+        all.push_back(*task);
+        if (task->id % 2 == 0) {
+            queue.push_front(*task);
+        }
+    }
+    EXPECT_EQ(all.size(), 10);
+    EXPECT_EQ(queue.size(), 5);
+    EXPECT_THROW(queue.push_back(*tasks[0]), std::invalid_argument);
+
+    std::vector<int> ids;
+    for (const auto& task : queue) {
+        ids.push_back(task.id);
+    }
+    EXPECT_EQ(ids, std::vector<int>({8, 6, 4, 2, 0}));
+
+    auto it = queue.iterator_to(*tasks[4]);
+    EXPECT_TRUE(queue.erase(*tasks[4]));
+    EXPECT_FALSE(queue.erase(*tasks[4]));
+    EXPECT_EQ(queue.iterator_to(*tasks[4]), queue.end());
+    EXPECT_TRUE(tasks[4]->queue_hook.in_use());
+    EXPECT_TRUE(tasks[4]->all_hook.in_use());
+    ++it;
+    EXPECT_EQ(it->id, 2);
+    EXPECT_FALSE(tasks[4]->queue_hook.in_use());
+
+    queue.insert(it, *tasks[4]);
+    EXPECT_EQ(queue.try_pop_front(), tasks[8].get());
+    ids.clear();
+    for (const auto& task : queue) {
+        ids.push_back(task.id);
+    }
+    EXPECT_EQ(ids, std::vector<int>({6, 4, 2, 0}));
+
+    queue.clear();
+    all.clear();
+    EXPECT_EQ(queue.try_pop_front(), nullptr);
+    EXPECT_TRUE(tasks[2]->queue_hook.in_use());
+    it = queue.end();
+    for (auto& task : tasks) {
+        EXPECT_FALSE(task->queue_hook.in_use());
+        EXPECT_FALSE(task->all_hook.in_use());
+    }
+}
+
+TEST(IntrusiveListTest, IteratorOutlivesErasedObjects) {
+    std::vector<std::unique_ptr<IntrusiveTask>> tasks;
+    polyndrom::intrusive_list<IntrusiveTask, &IntrusiveTask::all_hook> list;
+    for (int i = 0; i < 5; i++) {
+        tasks.push_back(std::make_unique<IntrusiveTask>(i));
+        list.push_back(*tasks.back());
+    }
+    auto it = std::next(list.begin());
+    for (int i = 1; i < 4; i++) {
+        list.erase(*tasks[i]);
+    }
+    EXPECT_TRUE(tasks[2]->all_hook.in_use());
+    ++it;
+    EXPECT_EQ(it->id, 4);
+    --it;
+    EXPECT_EQ(it->id, 0);
+    for (auto& task : tasks) {
+        EXPECT_EQ(task->all_hook.in_use(), task->id == 0 || task->id == 4);
+    }
+}
+
+#ifndef NDEBUG
+TEST(IntrusiveListDeathTest, RejectsObjectsOfOtherLists) {
+    IntrusiveTask task(0);
+    polyndrom::intrusive_list<IntrusiveTask, &IntrusiveTask::queue_hook> queue;
+    polyndrom::intrusive_list<IntrusiveTask, &IntrusiveTask::queue_hook> other;
+    queue.push_back(task);
+    EXPECT_DEATH(other.erase(task), "");
+    EXPECT_DEATH(other.iterator_to(task), "");
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(other.size(), 0);
+    EXPECT_TRUE(queue.erase(task));
+}
+#endif
+
+TEST(ConcurrentLruTest, EvictsLeastRecentlyUsed) {
+    polyndrom::concurrent_lru<int, std::string> cache(4);
+    for (int i = 1; i <= 4; i++) {
+        cache.put(i, std::to_string(i));
+    }
+    EXPECT_EQ(cache.get(1), "1");
+    cache.put(5, "5");
+    EXPECT_EQ(cache.size(), 4);
+    EXPECT_EQ(cache.get(2), std::nullopt);
+    cache.put(3, "three");
+    cache.put(6, "6");
+    EXPECT_EQ(cache.get(4), std::nullopt);
+    EXPECT_EQ(cache.get(1), "1");
+    EXPECT_EQ(cache.get(3), "three");
+    EXPECT_TRUE(cache.erase(5));
+    EXPECT_FALSE(cache.erase(5));
+    EXPECT_EQ(cache.size(), 3);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.evictions, 2);
+}
+
+TEST(ConcurrentLruTest, SpliceKeepsIterators) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 5; i++) {
+        list.push_back(i);
+    }
+    auto third = std::next(list.begin(), 3);
+    EXPECT_TRUE(list.splice(list.begin(), third));
+    EXPECT_TRUE(list.splice(list.end(), std::next(list.begin())));
+    EXPECT_TRUE(list.splice(third, third));
+    EXPECT_EQ(list.snapshot(), std::vector<int>({3, 1, 2, 4, 0}));
+    EXPECT_EQ(*std::next(third), 1);
+    EXPECT_EQ(**list.try_back(), 0);
+    auto erased = std::next(list.begin());
+    list.erase(erased);
+    EXPECT_FALSE(list.splice(list.begin(), erased));
+    EXPECT_EQ(list.snapshot(), std::vector<int>({3, 2, 4, 0}));
+    EXPECT_EQ(list.size(), 4);
+}
+
+TEST(WorkPartitionTest, VisitsEveryElementOnce) {
+    polyndrom::acid_list<int> list;
+    for (int i = 0; i < 1000; i++) {
+        list.push_back(i);
+    }
+    for (size_t workers_count : {1, 3}) {
+        auto work = list.partition(workers_count);
+        std::vector<int> visits(1000, 0);
+        for (size_t worker = workers_count; worker-- > 0;) {
+            work.run(worker, [&visits](int value) {
+                ++visits[value];
+            });
+        }
+        EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), 1000);
+    }
+    polyndrom::acid_list<int> empty;
+    auto work = empty.partition(2);
+    work.run(1, [](int) {
+        FAIL();
+    });
+    work.run(0, [](int) {
+        FAIL();
+    });
+}
+
+TEST(ContentionPolicyTest, ConstructorsKeepPolicy) {
+    using polyndrom::backoff_strategy;
+    polyndrom::acid_list<int64_t> list(polyndrom::contention_policy::exponential(8, 64));
+    EXPECT_EQ(list.contention_handling().strategy, backoff_strategy::exponential);
+    EXPECT_EQ(list.contention_handling().max_spins, 64);
+    polyndrom::acid_list<int64_t> bounded(polyndrom::list_capacity::elements(4), {}, polyndrom::contention_policy::none());
+    EXPECT_EQ(bounded.contention_handling().strategy, backoff_strategy::none);
+    polyndrom::acid_list<int64_t> defaulted;
+    EXPECT_EQ(defaulted.contention_handling().strategy, backoff_strategy::escalating);
+}
+
+TEST(ContentionPolicyTest, BackoffSteps) {
+    using step = polyndrom::detail::backoff::step;
+    auto steps_of = [](const polyndrom::contention_policy& policy, size_t attempts) {
+        polyndrom::detail::backoff wait(policy);
+        std::vector<step> steps;
+        for (size_t i = 0; i < attempts; i++) {
+            steps.push_back(wait());
+        }
+        return steps;
+    };
+    EXPECT_EQ(steps_of(polyndrom::contention_policy::none(), 3), std::vector<step>(3, step::none));
+    EXPECT_EQ(steps_of(polyndrom::contention_policy::exponential(8, 64), 12), std::vector<step>(12, step::spin));
+
+    // Spins double from min_spins until max_spins is reached: 4, 8, ..., 1024 takes nine
+    // attempts. Then it yields as many times as the policy says, and sleeps from then on.
+    auto escalating = steps_of(polyndrom::contention_policy::escalating(2, std::chrono::microseconds(1)), 14);
+    std::vector<step> expected(9, step::spin);
+    expected.insert(expected.end(), 2, step::yield);
+    expected.insert(expected.end(), 3, step::sleep);
+    EXPECT_EQ(escalating, expected);
+
+    polyndrom::contention_policy capped_early = polyndrom::contention_policy::escalating(0, std::chrono::microseconds(1));
+    capped_early.max_spins = capped_early.min_spins;
+    EXPECT_EQ(steps_of(capped_early, 3), std::vector<step>({step::spin, step::sleep, step::sleep}));
+}
+
+TEST(BatchIterationTest, ForwardAndReverse) {
+    polyndrom::acid_list<int64_t> list;
+    for (int64_t i = 0; i < 10; i++) {
+        list.push_back(i);
+    }
+    std::vector<std::vector<int64_t>> batches;
+    auto collect = [&batches](std::span<const int64_t> batch) {
+        batches.emplace_back(batch.begin(), batch.end());
+    };
+    list.for_each_batch(list.begin(), list.end(), 4, collect);
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9}}));
+
+    batches.clear();
+    list.reverse_for_each_batch(list.begin(), list.end(), 4, collect);
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{9, 8, 7, 6}, {5, 4, 3, 2}, {1, 0}}));
+
+    // Subranges, with the end erased between batches.
+    auto from = std::next(list.begin(), 2);
+    auto to = std::next(list.begin(), 6);
+    batches.clear();
+    list.reverse_for_each_batch(from, to, 3, collect);
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{5, 4, 3}, {2}}));
+    batches.clear();
+    list.for_each_batch(from, to, 2, [&](std::span<const int64_t> batch) {
+        collect(batch);
+        if (batches.size() == 1) {
+            list.erase(to);
+        }
+    });
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{2, 3}, {4, 5}, {7, 8}, {9}}));
+
+    batches.clear();
+    list.reverse_for_each_batch(from, from, 3, collect);
+    polyndrom::acid_list<int64_t> empty;
+    empty.for_each_batch(empty.begin(), empty.end(), 3, collect);
+    empty.reverse_for_each_batch(empty.begin(), empty.end(), 3, collect);
+    EXPECT_TRUE(batches.empty());
+}
+
+TEST(BatchIterationTest, ReverseStopsAtErasedBegin) {
+    std::vector<std::vector<int64_t>> batches;
+    auto collect = [&batches](std::span<const int64_t> batch) {
+        batches.emplace_back(batch.begin(), batch.end());
+    };
+    auto make_list = [](polyndrom::acid_list<int64_t>& list) {
+        for (int64_t i = 0; i < 10; i++) {
+            list.push_back(i);
+        }
+    };
+
+    // Erased before the call: the range starts at its live successor, in both directions.
+    polyndrom::acid_list<int64_t> list;
+    make_list(list);
+    auto from = std::next(list.begin(), 3);
+    auto to = std::next(list.begin(), 7);
+    list.erase(from);
+    list.reverse_for_each_batch(from, to, 2, collect);
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{6, 5}, {4}}));
+    batches.clear();
+    list.for_each_batch(from, to, 2, collect);
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{4, 5}, {6}}));
+
+    // Erased between batches.
+    polyndrom::acid_list<int64_t> during;
+    make_list(during);
+    from = std::next(during.begin(), 3);
+    to = std::next(during.begin(), 7);
+    batches.clear();
+    during.reverse_for_each_batch(from, to, 2, [&](std::span<const int64_t> batch) {
+        collect(batch);
+        if (batches.size() == 1) {
+            during.erase(from);
+        }
+    });
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{6, 5}, {4}}));
+
+    // Erased along with the nodes up to the last one visited.
+    polyndrom::acid_list<int64_t> emptied;
+    make_list(emptied);
+    from = std::next(emptied.begin(), 3);
+    to = std::next(emptied.begin(), 7);
+    batches.clear();
+    emptied.reverse_for_each_batch(from, to, 2, [&](std::span<const int64_t> batch) {
+        collect(batch);
+        if (batches.size() == 1) {
+            emptied.erase(from, std::next(from, 2));
+        }
+    });
+    EXPECT_EQ(batches, (std::vector<std::vector<int64_t>>{{6, 5}}));
+}
+
+namespace {
+
+// Counts what goes through to the upstream resource.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {
+    }
+
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream;
+};
+
+} // namespace
+
+TEST(AllocatorTest, PmrListAllocatesFromResource) {
+    CountingResource resource(std::pmr::new_delete_resource());
+    {
+        polyndrom::pmr::acid_list<int64_t> list(&resource);
+        EXPECT_EQ(resource.allocations, 2);
+        for (int64_t i = 0; i < 100; i++) {
+            list.push_back(i);
+        }
+        list.erase(list.begin());
+        EXPECT_EQ(resource.allocations, 102);
+        EXPECT_EQ(resource.deallocations, 1);
+        EXPECT_EQ(list.get_allocator().resource(), &resource);
+        EXPECT_EQ(std::accumulate(list.begin(), list.end(), int64_t{0}), 4950);
+    }
+    EXPECT_EQ(resource.deallocations, resource.allocations);
+
+    // Allocator-aware values get the list's allocator, like in standard containers.
+    polyndrom::pmr::acid_list<std::pmr::string> strings(&resource);
+    strings.push_back("a string long enough to live outside the small buffer");
+    EXPECT_EQ(strings.begin()->get_allocator().resource(), &resource);
+}
+
+TEST(AllocatorTest, DiscardSkipsReleaseForArena) {
+    std::pmr::monotonic_buffer_resource arena;
+    CountingResource resource(&arena);
+    size_t deallocations = 0;
+    {
+        polyndrom::pmr::acid_list<int64_t> list(polyndrom::list_capacity::elements(1000), {}, {}, &resource);
+        for (int64_t i = 0; i < 1000; i++) {
+            list.push_back(i);
+        }
+        auto it = std::next(list.begin(), 10);
+        list.erase(it);
+        it = list.end();
+        deallocations = resource.deallocations;
+        list.discard();
+        EXPECT_EQ(resource.deallocations, deallocations);
+        EXPECT_EQ(list.size(), 0);
+        EXPECT_EQ(list.begin(), list.end());
+
+        // The list stays usable, and the room taken by the discarded elements is given back.
+        EXPECT_TRUE(list.try_push_back(1));
+        EXPECT_EQ(list.size(), 1);
+        EXPECT_EQ(*list.begin(), 1);
+    }
+    // The element pushed after discard() and the two sentinels.
+    EXPECT_EQ(resource.deallocations, deallocations + 3);
+
+    CountingResource empty_resource(&arena);
+    {
+        polyndrom::pmr::acid_list<int64_t> empty(&empty_resource);
+        empty.discard();
+    }
+    EXPECT_EQ(empty_resource.allocations, 2);
+    EXPECT_EQ(empty_resource.deallocations, 2);
+}
+
+TEST(AllocatorTest, DiscardUncountsAbandonedErasedNodes) {
+    using List = polyndrom::pmr::acid_list<int64_t>;
+    size_t unreclaimed = List::unreclaimed_of_type().nodes;
+    std::pmr::monotonic_buffer_resource arena;
+    CountingResource resource(&arena);
+    {
+        List list(&resource);
+        list.track_erased(true);
+        list.track_history(true);
+        for (int64_t i = 0; i < 10; i++) {
+            list.push_back(i);
+        }
+        list.erase(list.begin());
+        list.erase(std::next(list.begin(), 3), std::next(list.begin(), 5));
+        EXPECT_EQ(List::unreclaimed_of_type().nodes, unreclaimed + 3);
+        list.discard();
+        EXPECT_EQ(List::unreclaimed_of_type().nodes, unreclaimed);
+    }
+    // Only the sentinels are returned, even with erased nodes linked to them abandoned.
+    EXPECT_EQ(resource.deallocations, 2);
+    arena.release();
+    EXPECT_EQ(List::unreclaimed_of_type().nodes, unreclaimed);
+}
+
+TEST(PriorityListTest, InsertSortedKeepsOrder) {
+    polyndrom::acid_list<int> list;
+    for (int value : {5, 1, 4, 1, 3, 9, 2, 6}) {
+        list.insert_sorted(value);
+    }
+    EXPECT_EQ(list.snapshot(), std::vector<int>({1, 1, 2, 3, 4, 5, 6, 9}));
+    auto four = std::next(list.begin(), 4);
+    list.insert_sorted(four, 7);
+    list.insert_sorted(four, 0);
+    list.erase(four);
+    list.insert_sorted(four, 4, std::less<>());
+    EXPECT_EQ(list.snapshot(), std::vector<int>({0, 1, 1, 2, 3, 4, 5, 6, 7, 9}));
+}
+
+TEST(PriorityListTest, DeleteMin) {
+    polyndrom::concurrent_priority_list<int, int> strict(polyndrom::delete_mode::strict);
+    std::mt19937 engine(42);
+    for (int i = 0; i < 1000; i++) {
+        strict.insert(static_cast<int>(engine() % 100), i);
+    }
+    EXPECT_EQ(strict.size(), 1000);
+    auto previous = strict.delete_min();
+    while (auto next = strict.delete_min()) {
+        ASSERT_LE(previous->priority, next->priority);
+        // Equal priorities come out in insertion order.
+        if (previous->priority == next->priority) {
+            ASSERT_LT(previous->value, next->value);
+        }
+        previous = next;
+    }
+    EXPECT_TRUE(strict.empty());
+
+    const size_t spray_width = 4;
+    polyndrom::concurrent_priority_list<int, int, std::greater<int>> relaxed(polyndrom::delete_mode::relaxed, spray_width);
+    for (int i = 0; i < 100; i++) {
+        relaxed.insert(i, i);
+    }
+    std::set<int> remaining;
+    for (int i = 0; i < 100; i++) {
+        remaining.insert(i);
+    }
+    while (auto entry = relaxed.delete_min()) {
+        EXPECT_EQ(entry->priority, entry->value);
+        // The entry is among the spray_width greatest priorities left.
+        auto found = remaining.find(entry->priority);
+        ASSERT_NE(found, remaining.end());
+        EXPECT_LE(std::distance(found, remaining.end()), static_cast<ptrdiff_t>(spray_width));
+        remaining.erase(found);
+    }
+    EXPECT_TRUE(remaining.empty());
+}
+
+TEST(HistoryTest, RollbackToCheckpoint) {
+    polyndrom::acid_list<int> list;
+    list.push_back(1);
+    list.track_history(true);
+    for (int i = 2; i <= 6; i++) {
+        list.push_back(i);
+    }
+    auto start = list.checkpoint();
+    auto third = std::next(list.begin(), 2);
+    size_t unreclaimed = polyndrom::acid_list<int>::unreclaimed_of_type().nodes;
+    list.erase(third);
+    list.erase(list.begin());
+    std::vector<int> replacement = {7, 8};
+    list.replace_range(list.begin(), std::next(list.begin(), 2), replacement.begin(), replacement.end());
+    list.insert_sorted(list.end(), 9);
+    EXPECT_EQ(list.try_pop_front(), 7);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({8, 5, 6, 9}));
+    EXPECT_EQ(polyndrom::acid_list<int>::unreclaimed_of_type().nodes, unreclaimed + 5);
+    EXPECT_EQ(list.history_size(), 13);
+
+    auto middle = list.checkpoint();
+    list.push_front(0);
+    list.rollback_to(middle);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({8, 5, 6, 9}));
+
+    // Erased nodes are linked back, so iterators to them are valid again.
+    list.rollback_to(start);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(list.size(), 6);
+    EXPECT_EQ(*third, 3);
+    EXPECT_EQ(*std::next(third), 4);
+    // The undone insertions were only kept by the log.
+    EXPECT_EQ(polyndrom::acid_list<int>::unreclaimed_of_type().nodes, unreclaimed);
+    EXPECT_EQ(list.history_size(), 5);
+
+    list.erase(third);
+    list.truncate_history(list.checkpoint());
+    EXPECT_EQ(list.history_size(), 0);
+    EXPECT_THROW(list.rollback_to(start), std::out_of_range);
+    list.push_back(10);
+    list.rollback_to(list.checkpoint());
+    list.track_history(false);
+    list.push_back(11);
+    EXPECT_EQ(list.history_size(), 0);
+    EXPECT_EQ(list.snapshot(), std::vector<int>({1, 2, 4, 5, 6, 10, 11}));
+}
+
+TEST(WeakIteratorTest, ExpiresWhenNodeIsReclaimed) {
+    using list_type = polyndrom::type_stable_list<int>;
+    list_type list;
+    for (int i = 0; i < 5; i++) {
+        list.push_back(i);
+    }
+    auto second = std::next(list.begin());
+    list_type::weak_iterator weak(second);
+    EXPECT_FALSE(weak.expired());
+    auto locked = weak.lock();
+    ASSERT_TRUE(locked);
+    EXPECT_EQ(**locked, 1);
+    EXPECT_EQ(*locked, second);
+
+    // Erased but still referenced: lock() succeeds and the iterator moves on from it.
+    const int* address = &*second;
+    list.erase(second);
+    locked = weak.lock();
+    ASSERT_TRUE(locked);
+    EXPECT_EQ(*std::next(*locked), 2);
+
+    // Once reclaimed, the weak iterator expires, even after the memory is reused.
+    second = list.end();
+    locked.reset();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(weak.lock(), std::nullopt);
+    list.push_back(5);
+    EXPECT_EQ(&*std::prev(list.end()), address);
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(list.snapshot(), std::vector<int>({0, 2, 3, 4, 5}));
+
+    EXPECT_TRUE(list_type::weak_iterator().expired());
+    EXPECT_TRUE(list_type::weak_iterator(list_type::iterator()).expired());
+    EXPECT_EQ(list_type::weak_iterator(list_type::iterator()).lock(), std::nullopt);
+}
@@ -6,9 +6,31 @@
 #include <functional>
 #include <random>
 #include <cassert>
+#include <coroutine>
+#include <exception>
 
 using Worker = std::function<void()>;
 
+// Fire-and-forget coroutine: starts eagerly and destroys its frame when it finishes.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() {
+        }
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
 std::vector<int> RandomIntVector(int n);
 
 std::vector<int> RandomUniqueIntVector(int n);